@@ -0,0 +1,95 @@
+#include "mapbox/io/io.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The iostream implementation `io.hpp` used before the POSIX backend.
+namespace reference {
+
+mapbox::base::expected<std::string, std::string> readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.good()) {
+        return mapbox::base::make_unexpected(std::string("Failed to read file '") + filename + std::string("'"));
+    }
+
+    std::stringstream data;
+    data << file.rdbuf();
+    return data.str();
+}
+
+mapbox::base::expected<void, std::string> writeFile(const std::string& filename, const std::string& data) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.good()) {
+        return mapbox::base::make_unexpected(std::string("Failed to write file '") + filename + std::string("'"));
+    }
+
+    file << data;
+    return {};
+}
+
+} // namespace reference
+
+using Clock = std::chrono::steady_clock;
+
+// Runs `fn` until `bytes` * iterations reaches ~256 MB, and returns the best
+// throughput of a few runs in MB/s.
+template <typename Fn>
+double throughput(std::size_t bytes, Fn&& fn) {
+    const std::size_t iterations = std::max<std::size_t>(1u, (256u << 20) / std::max<std::size_t>(bytes, 1u));
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run) {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            if (!fn()) {
+                std::fprintf(stderr, "I/O error\n");
+                std::exit(1);
+            }
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        best = std::max(best, static_cast<double>(bytes * iterations) / (1 << 20) / elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string directory = argc > 1 ? argv[1] : ".";
+    const std::string path = directory + "/bench_io.bin";
+
+    std::printf("%10s %16s %16s %16s %16s\n", "size", "read iostream", "read posix", "write iostream",
+                "write posix");
+    for (std::size_t size : {std::size_t(4) << 10, std::size_t(64) << 10, std::size_t(1) << 20, std::size_t(16) << 20}) {
+        std::string data(size, '\0');
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(i * 31 % 251);
+        }
+        if (!mapbox::base::io::writeFile(path, data)) {
+            std::fprintf(stderr, "Cannot write '%s'\n", path.c_str());
+            return 1;
+        }
+
+        const double readReference = throughput(size, [&] { return bool(reference::readFile(path)); });
+        const double read = throughput(size, [&] { return bool(mapbox::base::io::readFile(path)); });
+        const double writeReference = throughput(size, [&] { return bool(reference::writeFile(path, data)); });
+        const double write = throughput(size, [&] { return bool(mapbox::base::io::writeFile(path, data)); });
+
+        std::printf("%8zuKB %11.0f MB/s %11.0f MB/s %11.0f MB/s %11.0f MB/s\n",
+                    size >> 10,
+                    readReference,
+                    read,
+                    writeReference,
+                    write);
+    }
+
+    mapbox::base::io::deleteFile(path);
+    return 0;
+}
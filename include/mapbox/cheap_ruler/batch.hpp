@@ -0,0 +1,597 @@
+#pragma once
+
+#include <mapbox/cheap_ruler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "mapbox/platform.hpp"
+#include "mapbox/util/cpu.hpp"
+
+#if MB_ARCH == MB_ARCH_X86_64 || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define MB_BATCH_RULER_SSE2 1
+#    include <emmintrin.h>
+#endif
+
+#if MB_BATCH_RULER_SSE2 && (MB_COMPILER == MB_COMPILER_GNU || MB_COMPILER == MB_COMPILER_CLANG)
+#    define MB_BATCH_RULER_AVX2 1
+#    include <immintrin.h>
+#endif
+
+#if MB_ARCH == MB_ARCH_ARM64
+#    define MB_BATCH_RULER_NEON 1
+#    include <arm_neon.h>
+#endif
+
+namespace mapbox {
+namespace base {
+
+/// @cond internal
+namespace internal {
+namespace batch_ruler {
+
+// Longitude difference wrapped to [-180, 180], same as `std::remainder(a - b, 360)`.
+inline double longDiff(double a, double b) {
+    return std::remainder(a - b, 360.0);
+}
+
+struct Kernels {
+    void (*distances)(const double*, const double*, const double*, const double*, std::size_t, double, double, double*);
+    double (*sumDistances)(const double*, const double*, const double*, const double*, std::size_t, double, double);
+    std::size_t (*insideBBox)(
+        const double*, const double*, std::size_t, double, double, double, double, uint8_t*);
+};
+
+namespace scalar {
+
+inline void distances(const double* lons1,
+                      const double* lats1,
+                      const double* lons2,
+                      const double* lats2,
+                      std::size_t count,
+                      double kx,
+                      double ky,
+                      double* out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        const double dx = longDiff(lons1[i], lons2[i]) * kx;
+        const double dy = (lats1[i] - lats2[i]) * ky;
+        out[i] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+inline double sumDistances(const double* lons1,
+                           const double* lats1,
+                           const double* lons2,
+                           const double* lats2,
+                           std::size_t count,
+                           double kx,
+                           double ky) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const double dx = longDiff(lons1[i], lons2[i]) * kx;
+        const double dy = (lats1[i] - lats2[i]) * ky;
+        sum += std::sqrt(dx * dx + dy * dy);
+    }
+    return sum;
+}
+
+inline std::size_t insideBBox(const double* lons,
+                              const double* lats,
+                              std::size_t count,
+                              double minX,
+                              double minY,
+                              double maxX,
+                              double maxY,
+                              uint8_t* out) {
+    std::size_t inside = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const bool result = lats[i] >= minY && lats[i] <= maxY && longDiff(lons[i], minX) >= 0 &&
+                            longDiff(lons[i], maxX) <= 0;
+        if (out) out[i] = static_cast<uint8_t>(result);
+        inside += static_cast<std::size_t>(result);
+    }
+    return inside;
+}
+
+inline const Kernels& kernels() {
+    static const Kernels table{distances, sumDistances, insideBBox};
+    return table;
+}
+
+} // namespace scalar
+
+#if MB_BATCH_RULER_SSE2
+namespace sse2 {
+
+// d - 360 * round(d / 360) for lanes where |d| > 180. The subtraction is exact,
+// so the result matches std::remainder().
+inline __m128d wrap(__m128d d) {
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    const __m128d needsWrap = _mm_cmpgt_pd(_mm_and_pd(d, absMask), _mm_set1_pd(180.0));
+    const __m128d turns = _mm_cvtepi32_pd(_mm_cvtpd_epi32(_mm_div_pd(d, _mm_set1_pd(360.0))));
+    const __m128d wrapped = _mm_sub_pd(d, _mm_mul_pd(turns, _mm_set1_pd(360.0)));
+    return _mm_or_pd(_mm_and_pd(needsWrap, wrapped), _mm_andnot_pd(needsWrap, d));
+}
+
+inline __m128d distance(__m128d lon1, __m128d lat1, __m128d lon2, __m128d lat2, __m128d kx, __m128d ky) {
+    const __m128d dx = _mm_mul_pd(wrap(_mm_sub_pd(lon1, lon2)), kx);
+    const __m128d dy = _mm_mul_pd(_mm_sub_pd(lat1, lat2), ky);
+    return _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+}
+
+inline void distances(const double* lons1,
+                      const double* lats1,
+                      const double* lons2,
+                      const double* lats2,
+                      std::size_t count,
+                      double kx,
+                      double ky,
+                      double* out) {
+    const __m128d vkx = _mm_set1_pd(kx);
+    const __m128d vky = _mm_set1_pd(ky);
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(out + i,
+                      distance(_mm_loadu_pd(lons1 + i),
+                               _mm_loadu_pd(lats1 + i),
+                               _mm_loadu_pd(lons2 + i),
+                               _mm_loadu_pd(lats2 + i),
+                               vkx,
+                               vky));
+    }
+    scalar::distances(lons1 + i, lats1 + i, lons2 + i, lats2 + i, count - i, kx, ky, out + i);
+}
+
+inline double sumDistances(const double* lons1,
+                           const double* lats1,
+                           const double* lons2,
+                           const double* lats2,
+                           std::size_t count,
+                           double kx,
+                           double ky) {
+    const __m128d vkx = _mm_set1_pd(kx);
+    const __m128d vky = _mm_set1_pd(ky);
+    __m128d sum = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        sum = _mm_add_pd(sum,
+                         distance(_mm_loadu_pd(lons1 + i),
+                                  _mm_loadu_pd(lats1 + i),
+                                  _mm_loadu_pd(lons2 + i),
+                                  _mm_loadu_pd(lats2 + i),
+                                  vkx,
+                                  vky));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, sum);
+    return lanes[0] + lanes[1] + scalar::sumDistances(lons1 + i, lats1 + i, lons2 + i, lats2 + i, count - i, kx, ky);
+}
+
+inline std::size_t insideBBox(const double* lons,
+                              const double* lats,
+                              std::size_t count,
+                              double minX,
+                              double minY,
+                              double maxX,
+                              double maxY,
+                              uint8_t* out) {
+    const __m128d vminX = _mm_set1_pd(minX);
+    const __m128d vminY = _mm_set1_pd(minY);
+    const __m128d vmaxX = _mm_set1_pd(maxX);
+    const __m128d vmaxY = _mm_set1_pd(maxY);
+    const __m128d zero = _mm_setzero_pd();
+    std::size_t inside = 0;
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d lon = _mm_loadu_pd(lons + i);
+        const __m128d lat = _mm_loadu_pd(lats + i);
+        __m128d mask = _mm_and_pd(_mm_cmpge_pd(lat, vminY), _mm_cmple_pd(lat, vmaxY));
+        mask = _mm_and_pd(mask, _mm_cmpge_pd(wrap(_mm_sub_pd(lon, vminX)), zero));
+        mask = _mm_and_pd(mask, _mm_cmple_pd(wrap(_mm_sub_pd(lon, vmaxX)), zero));
+        const int bits = _mm_movemask_pd(mask);
+        if (out) {
+            out[i] = static_cast<uint8_t>(bits & 1);
+            out[i + 1] = static_cast<uint8_t>((bits >> 1) & 1);
+        }
+        inside += static_cast<std::size_t>((bits & 1) + ((bits >> 1) & 1));
+    }
+    return inside + scalar::insideBBox(lons + i, lats + i, count - i, minX, minY, maxX, maxY, out ? out + i : nullptr);
+}
+
+inline const Kernels& kernels() {
+    static const Kernels table{distances, sumDistances, insideBBox};
+    return table;
+}
+
+} // namespace sse2
+#endif
+
+#if MB_BATCH_RULER_AVX2
+namespace avx2 {
+
+__attribute__((target("avx2"))) inline __m256d wrap(__m256d d) {
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d needsWrap = _mm256_cmp_pd(_mm256_and_pd(d, absMask), _mm256_set1_pd(180.0), _CMP_GT_OQ);
+    const __m256d turns =
+        _mm256_round_pd(_mm256_div_pd(d, _mm256_set1_pd(360.0)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const __m256d wrapped = _mm256_sub_pd(d, _mm256_mul_pd(turns, _mm256_set1_pd(360.0)));
+    return _mm256_blendv_pd(d, wrapped, needsWrap);
+}
+
+__attribute__((target("avx2"))) inline __m256d distance(
+    __m256d lon1, __m256d lat1, __m256d lon2, __m256d lat2, __m256d kx, __m256d ky) {
+    const __m256d dx = _mm256_mul_pd(wrap(_mm256_sub_pd(lon1, lon2)), kx);
+    const __m256d dy = _mm256_mul_pd(_mm256_sub_pd(lat1, lat2), ky);
+    return _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+}
+
+__attribute__((target("avx2"))) inline void distances(const double* lons1,
+                                                      const double* lats1,
+                                                      const double* lons2,
+                                                      const double* lats2,
+                                                      std::size_t count,
+                                                      double kx,
+                                                      double ky,
+                                                      double* out) {
+    const __m256d vkx = _mm256_set1_pd(kx);
+    const __m256d vky = _mm256_set1_pd(ky);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_pd(out + i,
+                         distance(_mm256_loadu_pd(lons1 + i),
+                                  _mm256_loadu_pd(lats1 + i),
+                                  _mm256_loadu_pd(lons2 + i),
+                                  _mm256_loadu_pd(lats2 + i),
+                                  vkx,
+                                  vky));
+    }
+    scalar::distances(lons1 + i, lats1 + i, lons2 + i, lats2 + i, count - i, kx, ky, out + i);
+}
+
+__attribute__((target("avx2"))) inline double sumDistances(const double* lons1,
+                                                           const double* lats1,
+                                                           const double* lons2,
+                                                           const double* lats2,
+                                                           std::size_t count,
+                                                           double kx,
+                                                           double ky) {
+    const __m256d vkx = _mm256_set1_pd(kx);
+    const __m256d vky = _mm256_set1_pd(ky);
+    __m256d sum = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sum = _mm256_add_pd(sum,
+                            distance(_mm256_loadu_pd(lons1 + i),
+                                     _mm256_loadu_pd(lats1 + i),
+                                     _mm256_loadu_pd(lons2 + i),
+                                     _mm256_loadu_pd(lats2 + i),
+                                     vkx,
+                                     vky));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) +
+           scalar::sumDistances(lons1 + i, lats1 + i, lons2 + i, lats2 + i, count - i, kx, ky);
+}
+
+__attribute__((target("avx2"))) inline std::size_t insideBBox(const double* lons,
+                                                              const double* lats,
+                                                              std::size_t count,
+                                                              double minX,
+                                                              double minY,
+                                                              double maxX,
+                                                              double maxY,
+                                                              uint8_t* out) {
+    const __m256d vminX = _mm256_set1_pd(minX);
+    const __m256d vminY = _mm256_set1_pd(minY);
+    const __m256d vmaxX = _mm256_set1_pd(maxX);
+    const __m256d vmaxY = _mm256_set1_pd(maxY);
+    const __m256d zero = _mm256_setzero_pd();
+    std::size_t inside = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d lon = _mm256_loadu_pd(lons + i);
+        const __m256d lat = _mm256_loadu_pd(lats + i);
+        __m256d mask = _mm256_and_pd(_mm256_cmp_pd(lat, vminY, _CMP_GE_OQ), _mm256_cmp_pd(lat, vmaxY, _CMP_LE_OQ));
+        mask = _mm256_and_pd(mask, _mm256_cmp_pd(wrap(_mm256_sub_pd(lon, vminX)), zero, _CMP_GE_OQ));
+        mask = _mm256_and_pd(mask, _mm256_cmp_pd(wrap(_mm256_sub_pd(lon, vmaxX)), zero, _CMP_LE_OQ));
+        const int bits = _mm256_movemask_pd(mask);
+        if (out) {
+            for (std::size_t lane = 0; lane < 4; ++lane) {
+                out[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+            }
+        }
+        inside += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(bits)));
+    }
+    return inside + scalar::insideBBox(lons + i, lats + i, count - i, minX, minY, maxX, maxY, out ? out + i : nullptr);
+}
+
+inline const Kernels& kernels() {
+    static const Kernels table{distances, sumDistances, insideBBox};
+    return table;
+}
+
+inline bool supported() {
+    return cpuSupports(CPUFeature::AVX2);
+}
+
+} // namespace avx2
+#endif
+
+#if MB_BATCH_RULER_NEON
+namespace neon {
+
+inline float64x2_t wrap(float64x2_t d) {
+    const uint64x2_t needsWrap = vcagtq_f64(d, vdupq_n_f64(180.0));
+    const float64x2_t turns = vrndnq_f64(vdivq_f64(d, vdupq_n_f64(360.0)));
+    const float64x2_t wrapped = vsubq_f64(d, vmulq_f64(turns, vdupq_n_f64(360.0)));
+    return vbslq_f64(needsWrap, wrapped, d);
+}
+
+inline float64x2_t distance(
+    float64x2_t lon1, float64x2_t lat1, float64x2_t lon2, float64x2_t lat2, float64x2_t kx, float64x2_t ky) {
+    const float64x2_t dx = vmulq_f64(wrap(vsubq_f64(lon1, lon2)), kx);
+    const float64x2_t dy = vmulq_f64(vsubq_f64(lat1, lat2), ky);
+    return vsqrtq_f64(vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy)));
+}
+
+inline void distances(const double* lons1,
+                      const double* lats1,
+                      const double* lons2,
+                      const double* lats2,
+                      std::size_t count,
+                      double kx,
+                      double ky,
+                      double* out) {
+    const float64x2_t vkx = vdupq_n_f64(kx);
+    const float64x2_t vky = vdupq_n_f64(ky);
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        vst1q_f64(out + i,
+                  distance(vld1q_f64(lons1 + i),
+                           vld1q_f64(lats1 + i),
+                           vld1q_f64(lons2 + i),
+                           vld1q_f64(lats2 + i),
+                           vkx,
+                           vky));
+    }
+    scalar::distances(lons1 + i, lats1 + i, lons2 + i, lats2 + i, count - i, kx, ky, out + i);
+}
+
+inline double sumDistances(const double* lons1,
+                           const double* lats1,
+                           const double* lons2,
+                           const double* lats2,
+                           std::size_t count,
+                           double kx,
+                           double ky) {
+    const float64x2_t vkx = vdupq_n_f64(kx);
+    const float64x2_t vky = vdupq_n_f64(ky);
+    float64x2_t sum = vdupq_n_f64(0.0);
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        sum = vaddq_f64(sum,
+                        distance(vld1q_f64(lons1 + i),
+                                 vld1q_f64(lats1 + i),
+                                 vld1q_f64(lons2 + i),
+                                 vld1q_f64(lats2 + i),
+                                 vkx,
+                                 vky));
+    }
+    return vgetq_lane_f64(sum, 0) + vgetq_lane_f64(sum, 1) +
+           scalar::sumDistances(lons1 + i, lats1 + i, lons2 + i, lats2 + i, count - i, kx, ky);
+}
+
+inline std::size_t insideBBox(const double* lons,
+                              const double* lats,
+                              std::size_t count,
+                              double minX,
+                              double minY,
+                              double maxX,
+                              double maxY,
+                              uint8_t* out) {
+    const float64x2_t vminX = vdupq_n_f64(minX);
+    const float64x2_t vminY = vdupq_n_f64(minY);
+    const float64x2_t vmaxX = vdupq_n_f64(maxX);
+    const float64x2_t vmaxY = vdupq_n_f64(maxY);
+    std::size_t inside = 0;
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const float64x2_t lon = vld1q_f64(lons + i);
+        const float64x2_t lat = vld1q_f64(lats + i);
+        uint64x2_t mask = vandq_u64(vcgeq_f64(lat, vminY), vcleq_f64(lat, vmaxY));
+        mask = vandq_u64(mask, vcgezq_f64(wrap(vsubq_f64(lon, vminX))));
+        mask = vandq_u64(mask, vclezq_f64(wrap(vsubq_f64(lon, vmaxX))));
+        const auto first = static_cast<uint8_t>(vgetq_lane_u64(mask, 0) & 1u);
+        const auto second = static_cast<uint8_t>(vgetq_lane_u64(mask, 1) & 1u);
+        if (out) {
+            out[i] = first;
+            out[i + 1] = second;
+        }
+        inside += std::size_t{first} + second;
+    }
+    return inside + scalar::insideBBox(lons + i, lats + i, count - i, minX, minY, maxX, maxY, out ? out + i : nullptr);
+}
+
+inline const Kernels& kernels() {
+    static const Kernels table{distances, sumDistances, insideBBox};
+    return table;
+}
+
+} // namespace neon
+#endif
+
+} // namespace batch_ruler
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Batch counterpart of \c mapbox::cheap_ruler::CheapRuler.
+ *
+ * Works on structure-of-arrays coordinate buffers (separate longitude and
+ * latitude arrays, in degrees) and processes several points per
+ * instruction using the widest SIMD kernel supported by the CPU, picked at
+ * runtime. Results match the scalar \c CheapRuler ones within floating
+ * point tolerance; \c lineDistance() sums in a different order.
+ *
+ * Longitude differences are wrapped to [-180, 180], as \c CheapRuler does.
+ */
+class BatchRuler {
+public:
+    /**
+     * @brief SIMD kernel used for the computations.
+     */
+    enum class Kernel { Scalar, SSE2, AVX2, NEON };
+
+    /**
+     * @brief Creates a ruler with the scale of \a ruler, using the best
+     * kernel for this CPU.
+     */
+    explicit BatchRuler(cheap_ruler::CheapRuler ruler) : BatchRuler(ruler, bestKernel()) {}
+
+    /**
+     * @brief Creates a ruler with the scale of \a ruler, using \a kernel
+     * if supported and the scalar one otherwise.
+     */
+    BatchRuler(cheap_ruler::CheapRuler ruler, Kernel kernel)
+        // CheapRuler keeps its scale private, unit steps give it back exactly.
+        : kx_(ruler.distance({0.0, 0.0}, {1.0, 0.0})),
+          ky_(ruler.distance({0.0, 0.0}, {0.0, 1.0})),
+          kernel_(supported(kernel) ? kernel : Kernel::Scalar),
+          kernels_(&kernels(kernel_)) {}
+
+    /**
+     * @brief Creates a ruler for the given \a latitude and \a unit.
+     */
+    explicit BatchRuler(double latitude, cheap_ruler::CheapRuler::Unit unit = cheap_ruler::CheapRuler::Kilometers)
+        : BatchRuler(cheap_ruler::CheapRuler(latitude, unit)) {}
+
+    /**
+     * @brief Returns whether \a kernel can run on this CPU.
+     */
+    static bool supported(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::Scalar:
+                return true;
+            case Kernel::SSE2:
+#if MB_BATCH_RULER_SSE2
+                return true;
+#else
+                return false;
+#endif
+            case Kernel::AVX2:
+#if MB_BATCH_RULER_AVX2
+                return internal::batch_ruler::avx2::supported();
+#else
+                return false;
+#endif
+            case Kernel::NEON:
+#if MB_BATCH_RULER_NEON
+                return true;
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the widest kernel supported by this CPU.
+     */
+    static Kernel bestKernel() {
+        static const Kernel best = supported(Kernel::AVX2)   ? Kernel::AVX2
+                                   : supported(Kernel::NEON) ? Kernel::NEON
+                                   : supported(Kernel::SSE2) ? Kernel::SSE2
+                                                             : Kernel::Scalar;
+        return best;
+    }
+
+    Kernel kernel() const { return kernel_; }
+
+    /**
+     * @brief Computes the distances between the point pairs
+     * (`lons1[i]`, `lats1[i]`) and (`lons2[i]`, `lats2[i]`) into `out[i]`.
+     */
+    void distances(const double* lons1,
+                   const double* lats1,
+                   const double* lons2,
+                   const double* lats2,
+                   std::size_t count,
+                   double* out) const {
+        kernels_->distances(lons1, lats1, lons2, lats2, count, kx_, ky_, out);
+    }
+
+    /**
+     * @brief Computes the distances from \a origin to every point
+     * (`lons[i]`, `lats[i]`) into `out[i]`.
+     */
+    void distances(cheap_ruler::point origin,
+                   const double* lons,
+                   const double* lats,
+                   std::size_t count,
+                   double* out) const {
+        constexpr std::size_t kChunk = 256;
+        double originLons[kChunk];
+        double originLats[kChunk];
+        std::fill(originLons, originLons + kChunk, origin.x);
+        std::fill(originLats, originLats + kChunk, origin.y);
+        for (std::size_t i = 0; i < count; i += kChunk) {
+            const std::size_t n = std::min(kChunk, count - i);
+            kernels_->distances(originLons, originLats, lons + i, lats + i, n, kx_, ky_, out + i);
+        }
+    }
+
+    /**
+     * @brief Returns the length of the line going through the \a count
+     * points (`lons[i]`, `lats[i]`).
+     */
+    double lineDistance(const double* lons, const double* lats, std::size_t count) const {
+        if (count < 2) return 0.0;
+        return kernels_->sumDistances(lons, lats, lons + 1, lats + 1, count - 1, kx_, ky_);
+    }
+
+    /**
+     * @brief Tests every point (`lons[i]`, `lats[i]`) against \a bbox.
+     *
+     * @param out if not null, receives `1` for the points inside the box and
+     * `0` for the others.
+     * @return the number of points inside the box.
+     */
+    std::size_t insideBBox(const double* lons,
+                           const double* lats,
+                           std::size_t count,
+                           const cheap_ruler::box& bbox,
+                           uint8_t* out = nullptr) const {
+        return kernels_->insideBBox(lons, lats, count, bbox.min.x, bbox.min.y, bbox.max.x, bbox.max.y, out);
+    }
+
+private:
+    static const internal::batch_ruler::Kernels& kernels(Kernel kernel) {
+        switch (kernel) {
+#if MB_BATCH_RULER_SSE2
+            case Kernel::SSE2:
+                return internal::batch_ruler::sse2::kernels();
+#endif
+#if MB_BATCH_RULER_AVX2
+            case Kernel::AVX2:
+                return internal::batch_ruler::avx2::kernels();
+#endif
+#if MB_BATCH_RULER_NEON
+            case Kernel::NEON:
+                return internal::batch_ruler::neon::kernels();
+#endif
+            default:
+                return internal::batch_ruler::scalar::kernels();
+        }
+    }
+
+    double kx_;
+    double ky_;
+    Kernel kernel_;
+    const internal::batch_ruler::Kernels* kernels_;
+};
+
+} // namespace base
+} // namespace mapbox
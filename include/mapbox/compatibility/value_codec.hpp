@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "mapbox/compatibility/value.hpp"
+#include "mapbox/util/expected.hpp"
+
+namespace mapbox {
+namespace base {
+
+/// @cond internal
+namespace internal {
+
+// The encoding is little-endian, the byte order of every platform the
+// library targets; big-endian hosts swap the bytes of numbers.
+constexpr bool isBigEndian() {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+    return __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+#else
+    return false;
+#endif
+}
+
+class ValueWriter {
+public:
+    explicit ValueWriter(std::string& out) : out_(out) {}
+
+    void writeValue(const Value& value) {
+        value.match([&](const NullValue&) { writePod(uint8_t{0}); },
+                    [&](const bool v) {
+                        writePod(uint8_t{1});
+                        writePod(static_cast<uint8_t>(v));
+                    },
+                    [&](const uint64_t v) {
+                        writePod(uint8_t{2});
+                        writePod(v);
+                    },
+                    [&](const int64_t v) {
+                        writePod(uint8_t{3});
+                        writePod(v);
+                    },
+                    [&](const double v) {
+                        writePod(uint8_t{4});
+                        writePod(v);
+                    },
+                    [&](const std::string& v) {
+                        writePod(uint8_t{5});
+                        writeString(v);
+                    },
+                    [&](const ValueArray& array) {
+                        writePod(uint8_t{6});
+                        writeEach(array, [&](const Value& item) { writeValue(item); });
+                    },
+                    [&](const ValueObject& object) {
+                        writePod(uint8_t{7});
+                        writeProperties(object);
+                    });
+    }
+
+    void writeProperties(const ValueObject& properties) {
+        writeEach(properties, [&](const std::pair<const std::string, Value>& property) {
+            writeString(property.first);
+            writeValue(property.second);
+        });
+    }
+
+protected:
+    template <typename T>
+    void writePod(const T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written.");
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        if (isBigEndian()) std::reverse(bytes, bytes + sizeof(T));
+        out_.append(bytes, sizeof(T));
+    }
+
+    void writeString(const std::string& value) {
+        writePod(static_cast<uint32_t>(value.size()));
+        out_.append(value);
+    }
+
+    template <typename Container, typename Fn>
+    void writeEach(const Container& container, Fn&& fn) {
+        writePod(static_cast<uint32_t>(container.size()));
+        for (const auto& item : container) {
+            fn(item);
+        }
+    }
+
+    std::string& out_;
+};
+
+class ValueReader {
+public:
+    ValueReader(const char* data, std::size_t size) : pos_(data), end_(data + size) {}
+
+    bool atEnd() const { return pos_ == end_; }
+
+    // Returns false if the data is truncated or malformed.
+    bool readValue(Value& value, std::size_t depth) {
+        uint8_t type = 0;
+        if (depth > kMaxDepth || !readPod(type)) return false;
+        switch (type) {
+            case 0:
+                value = NullValue{};
+                return true;
+            case 1: {
+                uint8_t v = 0;
+                if (!readPod(v)) return false;
+                value = v != 0u;
+                return true;
+            }
+            case 2:
+                return readAs<uint64_t>(value);
+            case 3:
+                return readAs<int64_t>(value);
+            case 4:
+                return readAs<double>(value);
+            case 5: {
+                std::string v;
+                if (!readString(v)) return false;
+                value = std::move(v);
+                return true;
+            }
+            case 6: {
+                ValueArray array;
+                if (!readEach(array, [&](Value& item) { return readValue(item, depth + 1); })) {
+                    return false;
+                }
+                value = std::move(array);
+                return true;
+            }
+            case 7: {
+                ValueObject object;
+                if (!readProperties(object, depth + 1)) return false;
+                value = std::move(object);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    bool readProperties(ValueObject& properties, std::size_t depth) {
+        uint32_t count = 0;
+        if (!readCount(count)) return false;
+        properties.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            std::string key;
+            Value value;
+            if (!readString(key) || !readValue(value, depth)) return false;
+            properties.emplace(std::move(key), std::move(value));
+        }
+        return true;
+    }
+
+protected:
+    // Guards against stack exhaustion on corrupted input.
+    static constexpr std::size_t kMaxDepth = 64;
+
+    template <typename T>
+    bool readPod(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read.");
+        if (static_cast<std::size_t>(end_ - pos_) < sizeof(T)) return false;
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, pos_, sizeof(T));
+        if (isBigEndian()) std::reverse(bytes, bytes + sizeof(T));
+        std::memcpy(&value, bytes, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    // Every element takes at least one byte, which bounds bogus counts.
+    bool readCount(uint32_t& count) { return readPod(count) && count <= static_cast<std::size_t>(end_ - pos_); }
+
+    bool readString(std::string& value) {
+        uint32_t size = 0;
+        if (!readCount(size)) return false;
+        value.assign(pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    template <typename Container, typename Fn>
+    bool readEach(Container& container, Fn&& fn) {
+        uint32_t count = 0;
+        if (!readCount(count)) return false;
+        container.resize(count);
+        for (auto& item : container) {
+            if (!fn(item)) return false;
+        }
+        return true;
+    }
+
+    template <typename T, typename Variant>
+    bool readAs(Variant& variant) {
+        T value{};
+        if (!readPod(value)) return false;
+        variant = value;
+        return true;
+    }
+
+    const char* pos_;
+    const char* end_;
+};
+
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Appends \a value to \a out in a flat binary encoding, which
+ * \c decodeValue() reads back.
+ *
+ * Every value starts with a one byte type tag: 0 null, 1 bool (one byte),
+ * 2 uint64, 3 int64, 4 double, 5 string, 6 array and 7 object. Strings are
+ * a uint32 byte count followed by UTF-8 bytes, arrays a uint32 count
+ * followed by the values, objects a uint32 count followed by key strings
+ * and values. Numbers are little-endian, and doubles IEEE 754.
+ */
+inline void encodeValue(const Value& value, std::string& out) {
+    internal::ValueWriter(out).writeValue(value);
+}
+
+/**
+ * @brief Decodes a value written by \c encodeValue().
+ *
+ * @return an error if the data is truncated, malformed or followed by
+ * extra bytes.
+ */
+inline expected<Value, std::string> decodeValue(const char* data, std::size_t size) {
+    internal::ValueReader reader(data, size);
+    Value value;
+    if (!reader.readValue(value, 0) || !reader.atEnd()) {
+        return make_unexpected(std::string("Invalid encoded value"));
+    }
+    return expected<Value, std::string>(std::move(value));
+}
+
+} // namespace base
+} // namespace mapbox
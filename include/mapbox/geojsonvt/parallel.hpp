@@ -0,0 +1,261 @@
+#pragma once
+
+#include <mapbox/geojsonvt.hpp>
+#include <mapbox/geometry/for_each_point.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mapbox/util/scheduler.hpp"
+
+namespace mapbox {
+namespace base {
+
+/**
+ * @brief Options controlling how \c ParallelGeoJSONVT distributes work.
+ */
+struct ParallelGeoJSONVTOptions {
+    /**
+     * Zoom level at which the source is split into independently tiled
+     * shards. The world is divided into `4^splitZoom` shards, each one
+     * owning the tiles below its quadrant. Values above 6 (4096 shards)
+     * and above the maximum zoom of the tiling options are clamped.
+     */
+    uint8_t splitZoom = 2;
+
+    /**
+     * Number of threads used for the initial tiling, `0` meaning
+     * `std::thread::hardware_concurrency()`.
+     */
+    std::size_t threads = 0;
+
+    /**
+     * If set, the initial tiling runs on this scheduler instead of
+     * dedicated threads, and \c threads is ignored.
+     */
+    Scheduler* scheduler = nullptr;
+};
+
+/**
+ * @brief Multithreaded driver on top of \c mapbox::geojsonvt::GeoJSONVT.
+ *
+ * The source features are partitioned into one shard per tile at
+ * `splitZoom` (features overlapping several shards, including their tile
+ * buffer, are copied into each of them) plus a low-zoom shard with all the
+ * features that serves zoom levels below `splitZoom`. Every shard is backed
+ * by its own \c GeoJSONVT index, built in parallel at construction time.
+ *
+ * \c getTile() only locks the shard the requested tile belongs to, so
+ * requests for tiles in different shards run concurrently. The produced
+ * tiles are identical to the ones of a single \c GeoJSONVT index built with
+ * the same options.
+ */
+class ParallelGeoJSONVT {
+public:
+    using Tile = geojsonvt::Tile;
+    using Options = geojsonvt::Options;
+
+    /**
+     * @brief Tiles \a source, splitting the work across threads.
+     *
+     * @param source GeoJSON source to tile.
+     * @param options options forwarded to every shard index.
+     * @param parallelOptions sharding and threading options.
+     */
+    explicit ParallelGeoJSONVT(const geojsonvt::geojson& source,
+                               const Options& options = Options(),
+                               const ParallelGeoJSONVTOptions& parallelOptions = ParallelGeoJSONVTOptions())
+        : options_(options),
+          splitZoom_(clampSplitZoom(parallelOptions.splitZoom, options.maxZoom)) {
+        auto features = source.match(
+            [](const geojsonvt::feature_collection& value) { return value; },
+            [](const geojsonvt::feature& value) { return geojsonvt::feature_collection{value}; },
+            [](const geojsonvt::geometry& value) { return geojsonvt::feature_collection{{value}}; });
+
+        // Identifiers are generated from the position in the whole source, which
+        // the shards would not know about.
+        Options shardOptions = options;
+        if (options.generateId) {
+            for (std::size_t i = 0; i < features.size(); ++i) {
+                features[i].id = uint64_t{i};
+            }
+            shardOptions.generateId = false;
+        }
+
+        const std::size_t z2 = std::size_t{1} << splitZoom_;
+        std::vector<geojsonvt::feature_collection> partitions(z2 * z2);
+        for (const auto& feature : features) {
+            forEachShard(feature, [&](std::size_t shard) { partitions[shard].push_back(feature); });
+        }
+
+        shards_.resize(partitions.size() + 1);
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(shards_.size());
+
+        // The low-zoom shard tiles every feature and is the longest task, start it first.
+        if (splitZoom_ > 0) {
+            Options lowOptions = shardOptions;
+            lowOptions.indexMaxZoom = std::min<uint8_t>(lowOptions.indexMaxZoom, splitZoom_ - 1);
+            tasks.emplace_back([this, &features, lowOptions] {
+                shards_[0] = std::make_unique<Shard>(features, lowOptions);
+            });
+        }
+        for (std::size_t i = 0; i < partitions.size(); ++i) {
+            if (partitions[i].empty()) continue;
+            tasks.emplace_back([this, &partitions, shardOptions, i] {
+                shards_[i + 1] = std::make_unique<Shard>(partitions[i], shardOptions);
+                partitions[i].clear();
+            });
+        }
+
+        if (parallelOptions.scheduler) {
+            parallelFor(*parallelOptions.scheduler, 0, tasks.size(), [&tasks](std::size_t i) { tasks[i](); });
+        } else {
+            runParallel(tasks, parallelOptions.threads);
+        }
+    }
+
+    ParallelGeoJSONVT(const ParallelGeoJSONVT&) = delete;
+    ParallelGeoJSONVT& operator=(const ParallelGeoJSONVT&) = delete;
+
+    /**
+     * @brief Returns the tile at \a z / \a x / \a y, slicing it on demand.
+     *
+     * Safe to call concurrently from multiple threads. The returned
+     * reference stays valid for the lifetime of this object.
+     */
+    const Tile& getTile(const uint8_t z, const uint32_t x_, const uint32_t y) {
+        const uint32_t z2 = 1u << z;
+        const uint32_t x = ((x_ % z2) + z2) % z2;
+
+        std::size_t index = 0;
+        if (z >= splitZoom_) {
+            const uint32_t shift = z - splitZoom_;
+            index = std::size_t{y >> shift} * (std::size_t{1} << splitZoom_) + (x >> shift) + 1;
+        }
+
+        if (index >= shards_.size() || !shards_[index]) {
+            static const Tile emptyTile{};
+            return emptyTile;
+        }
+
+        Shard& shard = *shards_[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.index.getTile(z, x, y);
+    }
+
+    /**
+     * @brief Returns the options the source was tiled with.
+     */
+    const Options& options() const { return options_; }
+
+private:
+    struct Shard {
+        Shard(const geojsonvt::feature_collection& features, const Options& options) : index(features, options) {}
+
+        std::mutex mutex;
+        geojsonvt::GeoJSONVT index;
+    };
+
+    // Every shard is a `GeoJSONVT` index, keep their number reasonable.
+    static uint8_t clampSplitZoom(const uint8_t splitZoom, const uint8_t maxZoom) {
+        constexpr uint8_t maxSplitZoom = 6;
+        return std::min(std::min(splitZoom, maxZoom), maxSplitZoom);
+    }
+
+    static double projectX(const double x) { return x / 360 + 0.5; }
+
+    static double projectY(const double y) {
+        // M_PI is not standard and needs _USE_MATH_DEFINES on MSVC.
+        constexpr double pi = 3.14159265358979323846;
+        const double sine = std::sin(y * pi / 180);
+        const double y2 = 0.5 - 0.25 * std::log((1 + sine) / (1 - sine)) / pi;
+        return y2 < 0 ? 0 : y2 > 1 ? 1 : y2;
+    }
+
+    // Calls `fn` with the index of every shard (excluding the low-zoom one)
+    // whose buffered quadrant overlaps the feature.
+    template <typename Fn>
+    void forEachShard(const geojsonvt::feature& feature, Fn&& fn) const {
+        double minX = std::numeric_limits<double>::infinity();
+        double minY = minX;
+        double maxX = -minX;
+        double maxY = -minX;
+        mapbox::geometry::for_each_point(feature.geometry, [&](const mapbox::geometry::point<double>& p) {
+            minX = std::min(minX, p.x);
+            minY = std::min(minY, p.y);
+            maxX = std::max(maxX, p.x);
+            maxY = std::max(maxY, p.y);
+        });
+        if (minX > maxX) return;
+
+        const int64_t z2 = int64_t{1} << splitZoom_;
+        const double pad = static_cast<double>(options_.buffer) / options_.extent;
+        const auto toTile = [z2](double v) { return static_cast<int64_t>(std::floor(v * z2)); };
+
+        int64_t x0 = toTile(projectX(minX) - pad / z2);
+        int64_t x1 = toTile(projectX(maxX) + pad / z2);
+        // Latitudes grow northwards, tile rows southwards.
+        const int64_t y0 = std::max<int64_t>(toTile(projectY(maxY) - pad / z2), 0);
+        const int64_t y1 = std::min<int64_t>(toTile(projectY(minY) + pad / z2), z2 - 1);
+        if (x1 - x0 >= z2) {
+            x0 = 0;
+            x1 = z2 - 1;
+        }
+
+        for (int64_t y = y0; y <= y1; ++y) {
+            for (int64_t x = x0; x <= x1; ++x) {
+                fn(static_cast<std::size_t>(y * z2 + ((x % z2) + z2) % z2));
+            }
+        }
+    }
+
+    static void runParallel(const std::vector<std::function<void()>>& tasks, std::size_t threads) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = std::min(threads, tasks.size());
+
+        std::atomic_size_t next{0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        const auto worker = [&] {
+            for (std::size_t i = next++; i < tasks.size(); i = next++) {
+                try {
+                    tasks[i]();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < threads; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    const Options options_;
+    const uint8_t splitZoom_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace base
+} // namespace mapbox
@@ -0,0 +1,545 @@
+#pragma once
+
+#include <mapbox/geojsonvt.hpp>
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mapbox/compatibility/value_codec.hpp"
+#include "mapbox/io/io.hpp"
+#include "mapbox/io/mapped_file.hpp"
+#include "mapbox/platform.hpp"
+#include "mapbox/util/expected.hpp"
+
+namespace mapbox {
+namespace base {
+
+/// @cond internal
+namespace internal {
+
+class TileWriter : public ValueWriter {
+public:
+    explicit TileWriter(std::string& out) : ValueWriter(out) {}
+
+    void write(const geojsonvt::Tile& tile) {
+        writePod(tile.num_points);
+        writePod(tile.num_simplified);
+        writePod(static_cast<uint32_t>(tile.features.size()));
+        for (const auto& feature : tile.features) {
+            writeGeometry(feature.geometry);
+            writeIdentifier(feature.id);
+            writeProperties(feature.properties);
+        }
+    }
+
+private:
+    template <typename Points>
+    void writePoints(const Points& points) {
+        writePod(static_cast<uint32_t>(points.size()));
+        for (const auto& point : points) {
+            writePod(point.x);
+            writePod(point.y);
+        }
+    }
+
+    void writeGeometry(const mapbox::geometry::geometry<int16_t>& geometry) {
+        using namespace mapbox::geometry;
+        geometry.match(
+            [&](const empty&) { writePod(uint8_t{0}); },
+            [&](const point<int16_t>& p) {
+                writePod(uint8_t{1});
+                writePod(p.x);
+                writePod(p.y);
+            },
+            [&](const line_string<int16_t>& line) {
+                writePod(uint8_t{2});
+                writePoints(line);
+            },
+            [&](const polygon<int16_t>& polygon) {
+                writePod(uint8_t{3});
+                writeEach(polygon, [&](const linear_ring<int16_t>& ring) { writePoints(ring); });
+            },
+            [&](const multi_point<int16_t>& points) {
+                writePod(uint8_t{4});
+                writePoints(points);
+            },
+            [&](const multi_line_string<int16_t>& lines) {
+                writePod(uint8_t{5});
+                writeEach(lines, [&](const line_string<int16_t>& line) { writePoints(line); });
+            },
+            [&](const multi_polygon<int16_t>& polygons) {
+                writePod(uint8_t{6});
+                writeEach(polygons, [&](const polygon<int16_t>& polygon) {
+                    writeEach(polygon, [&](const linear_ring<int16_t>& ring) { writePoints(ring); });
+                });
+            },
+            [&](const geometry_collection<int16_t>& collection) {
+                writePod(uint8_t{7});
+                writeEach(collection, [&](const mapbox::geometry::geometry<int16_t>& item) { writeGeometry(item); });
+            });
+    }
+
+    void writeIdentifier(const mapbox::feature::identifier& id) {
+        id.match([&](const mapbox::feature::null_value_t&) { writePod(uint8_t{0}); },
+                 [&](const uint64_t value) {
+                     writePod(uint8_t{1});
+                     writePod(value);
+                 },
+                 [&](const int64_t value) {
+                     writePod(uint8_t{2});
+                     writePod(value);
+                 },
+                 [&](const double value) {
+                     writePod(uint8_t{3});
+                     writePod(value);
+                 },
+                 [&](const std::string& value) {
+                     writePod(uint8_t{4});
+                     writeString(value);
+                 });
+    }
+};
+
+class TileReader : public ValueReader {
+public:
+    TileReader(const char* data, std::size_t size) : ValueReader(data, size) {}
+
+    // Returns false if the data is truncated or malformed.
+    bool read(geojsonvt::Tile& tile) {
+        uint32_t count = 0;
+        if (!readPod(tile.num_points) || !readPod(tile.num_simplified) || !readCount(count)) return false;
+        tile.features.clear();
+        tile.features.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            mapbox::feature::feature<int16_t> feature;
+            if (!readGeometry(feature.geometry, 0) || !readIdentifier(feature.id) ||
+                !readProperties(feature.properties, 0)) {
+                return false;
+            }
+            tile.features.push_back(std::move(feature));
+        }
+        return atEnd();
+    }
+
+private:
+    template <typename Points>
+    bool readPoints(Points& points) {
+        uint32_t count = 0;
+        if (!readCount(count)) return false;
+        points.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            mapbox::geometry::point<int16_t> point;
+            if (!readPod(point.x) || !readPod(point.y)) return false;
+            points.push_back(point);
+        }
+        return true;
+    }
+
+    bool readPolygon(mapbox::geometry::polygon<int16_t>& polygon) {
+        return readEach(polygon, [&](mapbox::geometry::linear_ring<int16_t>& ring) { return readPoints(ring); });
+    }
+
+    bool readGeometry(mapbox::geometry::geometry<int16_t>& geometry, std::size_t depth) {
+        using namespace mapbox::geometry;
+        uint8_t type = 0;
+        if (depth > kMaxDepth || !readPod(type)) return false;
+        switch (type) {
+            case 0:
+                geometry = empty{};
+                return true;
+            case 1: {
+                point<int16_t> p;
+                if (!readPod(p.x) || !readPod(p.y)) return false;
+                geometry = p;
+                return true;
+            }
+            case 2: {
+                line_string<int16_t> line;
+                if (!readPoints(line)) return false;
+                geometry = std::move(line);
+                return true;
+            }
+            case 3: {
+                polygon<int16_t> polygon;
+                if (!readPolygon(polygon)) return false;
+                geometry = std::move(polygon);
+                return true;
+            }
+            case 4: {
+                multi_point<int16_t> points;
+                if (!readPoints(points)) return false;
+                geometry = std::move(points);
+                return true;
+            }
+            case 5: {
+                multi_line_string<int16_t> lines;
+                if (!readEach(lines, [&](line_string<int16_t>& line) { return readPoints(line); })) return false;
+                geometry = std::move(lines);
+                return true;
+            }
+            case 6: {
+                multi_polygon<int16_t> polygons;
+                if (!readEach(polygons, [&](polygon<int16_t>& polygon) { return readPolygon(polygon); })) return false;
+                geometry = std::move(polygons);
+                return true;
+            }
+            case 7: {
+                geometry_collection<int16_t> collection;
+                if (!readEach(collection, [&](mapbox::geometry::geometry<int16_t>& item) {
+                        return readGeometry(item, depth + 1);
+                    })) {
+                    return false;
+                }
+                geometry = std::move(collection);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    bool readIdentifier(mapbox::feature::identifier& id) {
+        uint8_t type = 0;
+        if (!readPod(type)) return false;
+        switch (type) {
+            case 0:
+                id = mapbox::feature::null_value_t{};
+                return true;
+            case 1:
+                return readAs<uint64_t>(id);
+            case 2:
+                return readAs<int64_t>(id);
+            case 3:
+                return readAs<double>(id);
+            case 4: {
+                std::string value;
+                if (!readString(value)) return false;
+                id = std::move(value);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+};
+
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Persistent cache of tiles produced by geojson-vt-cpp.
+ *
+ * Tiles are keyed by a hash of the source contents and tiling options (see
+ * \c hashSource()) plus their z/x/y coordinates, and are kept in a single
+ * cache file that is memory-mapped on \c open(), so that a warm start only
+ * needs lookups instead of re-tiling the source.
+ *
+ * Tiles added with \c put() are kept in memory until \c flush() rewrites
+ * the cache file through the io layer. The cache is bounded by a byte
+ * budget, evicting the least recently used tiles first.
+ *
+ * All the methods are thread-safe.
+ */
+class TileCache {
+public:
+    using Tile = geojsonvt::Tile;
+
+    /**
+     * @brief Creates a cache backed by the file at \a path.
+     *
+     * @param path cache file location.
+     * @param maxBytes budget for the serialized tiles.
+     */
+    TileCache(std::string path, std::size_t maxBytes) : path_(std::move(path)), maxBytes_(maxBytes) {}
+
+    TileCache(const TileCache&) = delete;
+    TileCache& operator=(const TileCache&) = delete;
+
+    /**
+     * @brief Hashes the source contents and the options it is tiled with
+     * (FNV-1a, 64 bits), so that tiles made with different options do not
+     * share keys.
+     */
+    static uint64_t hashSource(const std::string& source, const geojsonvt::Options& options = geojsonvt::Options()) {
+        uint64_t hash = 14695981039346656037ull;
+        const auto mix = [&hash](const char* data, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= static_cast<uint8_t>(data[i]);
+                hash *= 1099511628211ull;
+            }
+        };
+        const auto mixValue = [&mix](const auto value) {
+            mix(reinterpret_cast<const char*>(&value), sizeof(value)); // NOLINT cppcoreguidelines-pro-type-reinterpret-cast
+        };
+        mix(source.data(), source.size());
+        mixValue(options.maxZoom);
+        mixValue(options.indexMaxZoom);
+        mixValue(options.indexMaxPoints);
+        mixValue(options.generateId);
+        mixValue(options.tolerance);
+        mixValue(options.extent);
+        mixValue(options.buffer);
+        mixValue(options.lineMetrics);
+        return hash;
+    }
+
+    /**
+     * @brief Maps the cache file, dropping any tile held in memory.
+     *
+     * A missing cache file is not an error and results in an empty cache.
+     *
+     * @return an error if the file exists but cannot be mapped or is not a
+     * valid cache file.
+     */
+    expected<void, io::ErrorType> open() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        lru_.clear();
+        bytes_ = 0u;
+        mapping_ = io::MappedFile();
+
+        auto mapped = io::MappedFile::open(path_);
+        if (!mapped) {
+            struct stat info {};
+            if (::stat(path_.c_str(), &info) != 0 && errno == ENOENT) {
+                return expected<void, io::ErrorType>();
+            }
+            return make_unexpected(std::string(mapped.error()));
+        }
+
+        const char* data = mapped->data();
+        const std::size_t size = mapped->size();
+        const auto invalid = [this] {
+            return make_unexpected(std::string("Invalid tile cache file '") + path_ + std::string("'"));
+        };
+
+        Header header{};
+        if (size < sizeof(Header)) return invalid();
+        std::memcpy(&header, data, sizeof(Header));
+        if (header.magic != kMagic || header.version != kVersion || header.indexOffset > size ||
+            header.count > (size - header.indexOffset) / sizeof(IndexEntry)) {
+            return invalid();
+        }
+
+        for (uint64_t i = 0; i < header.count; ++i) {
+            IndexEntry index{};
+            std::memcpy(&index, data + header.indexOffset + i * sizeof(IndexEntry), sizeof(IndexEntry));
+            if (index.offset < sizeof(Header) || index.offset > header.indexOffset ||
+                index.size > header.indexOffset - index.offset) {
+                entries_.clear();
+                lru_.clear();
+                bytes_ = 0u;
+                return invalid();
+            }
+            insert(Key{index.source, index.tile}, Entry{static_cast<std::size_t>(index.offset),
+                                                       static_cast<std::size_t>(index.size), std::string(), true});
+        }
+
+        mapping_ = std::move(*mapped);
+        evict();
+        return expected<void, io::ErrorType>();
+    }
+
+    /**
+     * @brief Looks up a tile, marking it as the most recently used one.
+     *
+     * @return true if the tile was found and decoded into \a tile.
+     */
+    bool get(uint64_t source, uint8_t z, uint32_t x, uint32_t y, Tile& tile) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = entries_.find(Key{source, tileId(z, x, y)});
+        if (it == entries_.end()) return false;
+
+        lru_.splice(lru_.end(), lru_, it->second);
+        const Entry& entry = it->second->second;
+        const char* data = entry.mapped ? mapping_.data() + entry.offset : entry.data.data();
+        internal::TileReader reader(data, entry.size);
+        return reader.read(tile);
+    }
+
+    /**
+     * @brief Returns the cached tile, or creates it with \a makeTile and
+     * stores it in the cache.
+     */
+    template <typename Fn>
+    Tile getTile(uint64_t source, uint8_t z, uint32_t x, uint32_t y, Fn&& makeTile) {
+        Tile tile;
+        if (!get(source, z, x, y, tile)) {
+            tile = makeTile();
+            put(source, z, x, y, tile);
+        }
+        return tile;
+    }
+
+    /**
+     * @brief Stores a tile in memory, evicting the least recently used
+     * tiles if the budget is exceeded.
+     */
+    void put(uint64_t source, uint8_t z, uint32_t x, uint32_t y, const Tile& tile) {
+        std::string data;
+        internal::TileWriter(data).write(tile);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Key key{source, tileId(z, x, y)};
+        const auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            bytes_ -= it->second->second.size;
+            lru_.erase(it->second);
+            entries_.erase(it);
+        }
+        const std::size_t size = data.size();
+        insert(key, Entry{0u, size, std::move(data), false});
+        evict();
+    }
+
+    /**
+     * @brief Writes all the cached tiles to the cache file and maps it.
+     *
+     * The file is replaced with \c io::writeFileAtomic(), so a crash never
+     * leaves a partially written cache behind.
+     */
+    expected<void, io::ErrorType> flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Tiles are 8-byte aligned and followed by the index.
+        std::vector<std::size_t> offsets;
+        std::string index;
+        offsets.reserve(lru_.size());
+        index.reserve(lru_.size() * sizeof(IndexEntry));
+        std::size_t end = sizeof(Header);
+        for (const auto& item : lru_) {
+            const IndexEntry indexEntry{item.first.source, item.first.tile, end, item.second.size};
+            index.append(reinterpret_cast<const char*>(&indexEntry), sizeof(IndexEntry)); // NOLINT
+            offsets.push_back(end);
+            end += (item.second.size + 7u) / 8u * 8u;
+        }
+        const Header header{kMagic, kVersion, lru_.size(), end};
+
+        // Streamed to the file, without assembling it in memory.
+        auto written = io::writeFileAtomic(path_, [&](io::FileWriter& writer) {
+            static const char padding[8] = {};
+            if (!writer.write(reinterpret_cast<const char*>(&header), sizeof(Header))) return false; // NOLINT
+            for (const auto& item : lru_) {
+                const Entry& entry = item.second;
+                if (!writer.write(entry.mapped ? mapping_.data() + entry.offset : entry.data.data(), entry.size) ||
+                    !writer.write(padding, (8u - entry.size % 8u) % 8u)) {
+                    return false;
+                }
+            }
+            return writer.write(index.data(), index.size());
+        });
+        if (!written) {
+            return written;
+        }
+
+        auto mapped = io::MappedFile::open(path_);
+        if (!mapped) {
+            return nonstd::make_unexpected(mapped.error());
+        }
+        mapping_ = std::move(*mapped);
+
+        auto offset = offsets.begin();
+        for (auto& item : lru_) {
+            item.second = Entry{*offset++, item.second.size, std::string(), true};
+        }
+
+        return expected<void, io::ErrorType>();
+    }
+
+    /**
+     * @brief Number of cached tiles.
+     */
+    std::size_t count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    /**
+     * @brief Size of the serialized cached tiles, in bytes.
+     */
+    std::size_t bytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bytes_;
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x4354424d; // "MBTC"
+    static constexpr uint32_t kVersion = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t count;
+        uint64_t indexOffset;
+    };
+
+    struct IndexEntry {
+        uint64_t source;
+        uint64_t tile;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct Key {
+        uint64_t source;
+        uint64_t tile;
+
+        bool operator==(const Key& other) const { return source == other.source && tile == other.tile; }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            return static_cast<std::size_t>(key.source ^ (key.tile * 0x9e3779b97f4a7c15ull));
+        }
+    };
+
+    struct Entry {
+        std::size_t offset;
+        std::size_t size;
+        std::string data;
+        bool mapped;
+    };
+
+    using LRU = std::list<std::pair<Key, Entry>>;
+
+    static uint64_t tileId(uint8_t z, uint32_t x, uint32_t y) {
+        return (uint64_t{z} << 56) | (uint64_t{x} << 28) | uint64_t{y};
+    }
+
+    void insert(const Key& key, Entry entry) {
+        if (entries_.count(key) != 0u) return;
+        bytes_ += entry.size;
+        lru_.emplace_back(key, std::move(entry));
+        entries_[key] = std::prev(lru_.end());
+    }
+
+    void evict() {
+        while (bytes_ > maxBytes_ && !lru_.empty()) {
+            bytes_ -= lru_.front().second.size;
+            entries_.erase(lru_.front().first);
+            lru_.pop_front();
+        }
+    }
+
+    const std::string path_;
+    const std::size_t maxBytes_;
+
+    mutable std::mutex mutex_;
+    io::MappedFile mapping_;
+    LRU lru_;
+    std::unordered_map<Key, LRU::iterator, KeyHash> entries_;
+    std::size_t bytes_ = 0u;
+};
+
+} // namespace base
+} // namespace mapbox
@@ -0,0 +1,831 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mapbox/io/directory.hpp"
+#include "mapbox/io/io.hpp"
+#include "mapbox/io/mapped_file.hpp"
+#include "mapbox/platform.hpp"
+#include "mapbox/util/expected.hpp"
+#include "mapbox/util/trace.hpp"
+
+#if !MB_PLATFORM_IS_WIN32
+#    include <fcntl.h>
+#    include <sys/file.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace mapbox {
+namespace base {
+namespace io {
+
+/**
+ * @brief 128-bit key of a blob in a \c BlobCache.
+ */
+struct BlobKey {
+    uint64_t high = 0u;
+    uint64_t low = 0u;
+
+    bool operator==(const BlobKey& other) const { return high == other.high && low == other.low; }
+    bool operator!=(const BlobKey& other) const { return !(*this == other); }
+    bool operator<(const BlobKey& other) const {
+        return high < other.high || (high == other.high && low < other.low);
+    }
+
+    /**
+     * @brief Hashes \a size bytes at \a data (MurmurHash3, x64 128-bit
+     * variant).
+     */
+    static BlobKey hash(const char* data, std::size_t size) {
+        constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+        constexpr uint64_t c2 = 0x4cf5ad432745937full;
+        const auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+        const auto fmix = [](uint64_t k) {
+            k ^= k >> 33;
+            k *= 0xff51afd7ed558ccdull;
+            k ^= k >> 33;
+            k *= 0xc4ceb9fe1a85ec53ull;
+            k ^= k >> 33;
+            return k;
+        };
+
+        uint64_t h1 = 0u;
+        uint64_t h2 = 0u;
+        const std::size_t blocks = size / 16;
+        for (std::size_t i = 0; i < blocks; ++i) {
+            uint64_t k1;
+            uint64_t k2;
+            std::memcpy(&k1, data + i * 16, 8);
+            std::memcpy(&k2, data + i * 16 + 8, 8);
+
+            k1 *= c1;
+            k1 = rotl(k1, 31);
+            k1 *= c2;
+            h1 ^= k1;
+            h1 = rotl(h1, 27);
+            h1 += h2;
+            h1 = h1 * 5 + 0x52dce729;
+
+            k2 *= c2;
+            k2 = rotl(k2, 33);
+            k2 *= c1;
+            h2 ^= k2;
+            h2 = rotl(h2, 31);
+            h2 += h1;
+            h2 = h2 * 5 + 0x38495ab5;
+        }
+
+        const auto* tail = reinterpret_cast<const uint8_t*>(data + blocks * 16); // NOLINT
+        const std::size_t rest = size & 15u;
+        uint64_t k1 = 0u;
+        uint64_t k2 = 0u;
+        for (std::size_t i = rest; i > 8; --i) {
+            k2 ^= uint64_t{tail[i - 1]} << ((i - 9) * 8);
+        }
+        for (std::size_t i = std::min<std::size_t>(rest, 8u); i > 0; --i) {
+            k1 ^= uint64_t{tail[i - 1]} << ((i - 1) * 8);
+        }
+        if (rest > 8) {
+            k2 *= c2;
+            k2 = rotl(k2, 33);
+            k2 *= c1;
+            h2 ^= k2;
+        }
+        if (rest > 0) {
+            k1 *= c1;
+            k1 = rotl(k1, 31);
+            k1 *= c2;
+            h1 ^= k1;
+        }
+
+        h1 ^= size;
+        h2 ^= size;
+        h1 += h2;
+        h2 += h1;
+        h1 = fmix(h1);
+        h2 = fmix(h2);
+        h1 += h2;
+        h2 += h1;
+        return BlobKey{h1, h2};
+    }
+
+    static BlobKey hash(const std::string& data) { return hash(data.data(), data.size()); }
+};
+
+/**
+ * @brief Options of a \c BlobCache.
+ */
+struct BlobCacheOptions {
+    /// Budget for the cached blobs, the least recently used ones being
+    /// evicted beyond it.
+    uint64_t maxBytes = 256u << 20;
+
+    /// Size of the segment files blobs are packed in. Larger blobs get a
+    /// segment of their own.
+    uint64_t segmentSize = 16u << 20;
+
+    /// Opens the cache for reading only, without taking the writer lock.
+    /// Lookups then search the mapped index in place.
+    bool readOnly = false;
+};
+
+/// @cond internal
+namespace internal {
+
+#if !MB_PLATFORM_IS_WIN32
+
+/**
+ * @brief Segment file mapped into memory.
+ *
+ * The mapping may be larger than the file: blobs appended to the file
+ * later show up in it, since both share the page cache.
+ */
+class BlobSegment {
+public:
+    BlobSegment(FileDescriptor fd, const char* data, std::size_t capacity) noexcept
+        : fd_(std::move(fd)), data_(data), capacity_(capacity) {}
+
+    BlobSegment(const BlobSegment&) = delete;
+    BlobSegment& operator=(const BlobSegment&) = delete;
+
+    ~BlobSegment() {
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), capacity_); // NOLINT cppcoreguidelines-pro-type-const-cast
+        }
+    }
+
+    static std::shared_ptr<BlobSegment> open(const std::string& path, std::size_t capacity, bool writable) {
+        auto fd = FileDescriptor::open(path, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+        if (!fd) return nullptr;
+
+        const char* data = nullptr;
+        if (capacity > 0) {
+            void* addr = ::mmap(nullptr, capacity, PROT_READ, MAP_SHARED, fd.get(), 0);
+            if (addr == MAP_FAILED) return nullptr;
+            data = static_cast<const char*>(addr);
+        }
+        return std::make_shared<BlobSegment>(std::move(fd), data, capacity);
+    }
+
+    int fd() const noexcept { return fd_.get(); }
+    const char* data() const noexcept { return data_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    FileDescriptor fd_;
+    const char* const data_;
+    const std::size_t capacity_;
+};
+
+#endif
+
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Read-only view of a cached blob.
+ *
+ * Points into the mapped segment file, which the view keeps mapped even if
+ * the blob is evicted in the meantime.
+ */
+class BlobView {
+public:
+    BlobView() = default;
+
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0u; }
+
+    std::string str() const { return std::string(data_, size_); }
+
+private:
+    friend class BlobCache;
+
+    BlobView(std::shared_ptr<const void> owner, const char* data, std::size_t size)
+        : owner_(std::move(owner)), data_(data), size_(size) {}
+
+    std::shared_ptr<const void> owner_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0u;
+};
+
+/**
+ * @brief Persistent cache of blobs packed in segment files.
+ *
+ * Blobs are stored under a \c BlobKey, typically the hash of their
+ * contents or of their URL, and appended to segment files of
+ * \c BlobCacheOptions::segmentSize bytes instead of getting a file each.
+ * Lookups return views into the mapped segments, without copying.
+ *
+ * Blobs added with \c put() can be looked up right away, and are made
+ * persistent by \c commit(), which writes an index of the blobs next to
+ * its final location and renames it over it; a crash loses the blobs added
+ * since the last commit, but never leaves a partially written cache
+ * behind. The index lists the blobs sorted by key, so that read-only
+ * caches search it in place once mapped.
+ *
+ * The cache is bounded by a byte budget, evicting the least recently used
+ * blobs first. Segments are reclaimed on \c commit(): empty ones are
+ * deleted, and the blobs of segments less than half full are moved to the
+ * current segment first.
+ *
+ * A single process may open a directory for writing at a time, enforced
+ * with a lock file; any number of processes may open it read-only, and see
+ * the blobs committed at the time. All the methods are thread-safe:
+ * lookups run concurrently, and with the writing methods, which are
+ * serialized.
+ *
+ * Not implemented on Windows, where \c open() returns an error.
+ */
+class BlobCache {
+public:
+    /**
+     * @brief Creates a cache stored in the directory \a directory.
+     */
+    explicit BlobCache(std::string directory, BlobCacheOptions options = {})
+        : directory_(std::move(directory)), options_(options) {}
+
+    BlobCache(const BlobCache&) = delete;
+    BlobCache& operator=(const BlobCache&) = delete;
+
+    /**
+     * @brief Opens the cache, creating the directory if needed, and drops
+     * the blobs that were not committed.
+     *
+     * A missing index is not an error and results in an empty cache.
+     *
+     * @return an error if the cache is locked by another writer, or if the
+     * index or the segments are invalid.
+     */
+    expected<void, ErrorType> open() {
+        MB_TRACE_SCOPE("io::BlobCache::open");
+        std::lock_guard<std::mutex> writer(writerMutex_);
+        std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+        reset();
+#if MB_PLATFORM_IS_WIN32
+        return make_unexpected(std::string("Failed to open blob cache '") + directory_ + std::string("'"));
+#else
+        lock_.close();
+        if (!options_.readOnly) {
+            ::mkdir(directory_.c_str(), 0755);
+            lock_ = internal::FileDescriptor::open(directory_ + "/lock", O_RDWR | O_CREAT, 0644);
+            if (!lock_ || ::flock(lock_.get(), LOCK_EX | LOCK_NB) != 0) {
+                lock_.close();
+                return make_unexpected(std::string("Blob cache '") + directory_ +
+                                       std::string("' is locked by another writer"));
+            }
+        }
+
+        auto loaded = load();
+        if (!loaded) {
+            reset();
+            return loaded;
+        }
+        if (!options_.readOnly) {
+            removeOrphans();
+        }
+        return expected<void, ErrorType>();
+#endif
+    }
+
+    /**
+     * @brief Looks up a blob, marking it as the most recently used one.
+     *
+     * @return true if the blob was found, \a view then pointing to it.
+     */
+    bool get(const BlobKey& key, BlobView& view) const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+        uint32_t segment = 0u;
+        uint64_t offset = 0u;
+        uint64_t size = 0u;
+        if (index_.size() > 0u) {
+            const IndexEntry* entry = findIndexEntry(key);
+            if (!entry) return false;
+            segment = entry->segment;
+            offset = entry->offset;
+            size = entry->size;
+        } else {
+            const auto it = entries_.find(key);
+            if (it == entries_.end()) return false;
+            it->second.access = ++clock_;
+            segment = it->second.segment;
+            offset = it->second.offset;
+            size = it->second.size;
+        }
+
+        const auto& file = segments_.at(segment).file;
+        view = BlobView(file, file->data() + offset, static_cast<std::size_t>(size));
+        return true;
+    }
+
+    bool contains(const BlobKey& key) const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+        return index_.size() > 0u ? findIndexEntry(key) != nullptr : entries_.count(key) != 0u;
+    }
+
+    /**
+     * @brief Stores \a size bytes at \a data under their hash, unless
+     * already cached.
+     *
+     * @return the key of the blob.
+     */
+    expected<BlobKey, ErrorType> put(const char* data, std::size_t size) {
+        const BlobKey key = BlobKey::hash(data, size);
+        if (!contains(key)) {
+            auto stored = put(key, data, size);
+            if (!stored) {
+                return nonstd::make_unexpected(stored.error());
+            }
+        }
+        return key;
+    }
+
+    /**
+     * @brief Stores \a size bytes at \a data under \a key, replacing the
+     * blob already stored under it, and evicts the least recently used
+     * blobs if the budget is exceeded.
+     */
+    expected<void, ErrorType> put(const BlobKey& key, const char* data, std::size_t size) {
+        MB_TRACE_SCOPE("io::BlobCache::put");
+        std::lock_guard<std::mutex> writer(writerMutex_);
+        if (!writable()) {
+            return readOnlyError();
+        }
+#if !MB_PLATFORM_IS_WIN32
+        auto appended = append(data, size);
+        if (!appended) {
+            return nonstd::make_unexpected(appended.error());
+        }
+
+        std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+        Segment& segment = segments_.at(active_);
+        const auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            release(it);
+        }
+        entries_.emplace(std::piecewise_construct,
+                         std::forward_as_tuple(key),
+                         std::forward_as_tuple(active_, *appended, size, ++clock_));
+        segment.live += size;
+        bytes_ += size;
+        evict();
+#endif
+        return expected<void, ErrorType>();
+    }
+
+    expected<void, ErrorType> put(const BlobKey& key, const std::string& data) {
+        return put(key, data.data(), data.size());
+    }
+
+    /**
+     * @brief Removes a blob from the cache.
+     *
+     * @return false if the blob was not cached.
+     */
+    bool remove(const BlobKey& key) {
+        std::lock_guard<std::mutex> writer(writerMutex_);
+        std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+        if (!writable()) return false;
+        const auto it = entries_.find(key);
+        if (it == entries_.end()) return false;
+        release(it);
+        return true;
+    }
+
+    /**
+     * @brief Reclaims unused segments and makes the blobs added so far
+     * persistent.
+     *
+     * Segments are synced to disk before the index is replaced, and
+     * segments it does not refer to anymore are deleted afterwards.
+     */
+    expected<void, ErrorType> commit() {
+        MB_TRACE_SCOPE("io::BlobCache::commit");
+        std::lock_guard<std::mutex> writer(writerMutex_);
+        if (!writable()) {
+            return readOnlyError();
+        }
+#if !MB_PLATFORM_IS_WIN32
+        auto compacted = compact();
+        if (!compacted) {
+            return compacted;
+        }
+
+        for (const uint32_t id : unsynced_) {
+            const auto it = segments_.find(id);
+            if (it != segments_.end() && ::fsync(it->second.file->fd()) != 0) {
+                return writeError(segmentPath(id));
+            }
+        }
+        unsynced_.clear();
+
+        std::string out;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+            out = serializeIndex();
+        }
+        const std::string path = indexPath();
+        if (!writeFileAtomic(path, out)) {
+            return writeError(path);
+        }
+
+        for (const uint32_t id : dropped_) {
+            std::remove(segmentPath(id).c_str());
+        }
+        dropped_.clear();
+#endif
+        return expected<void, ErrorType>();
+    }
+
+    /**
+     * @brief Number of cached blobs.
+     */
+    std::size_t count() const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+        return index_.size() > 0u ? static_cast<std::size_t>(indexHeader().entryCount) : entries_.size();
+    }
+
+    /**
+     * @brief Size of the cached blobs, in bytes.
+     */
+    uint64_t bytes() const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+        return bytes_;
+    }
+
+    /**
+     * @brief Size of the segment files, in bytes.
+     */
+    uint64_t diskBytes() const {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+        uint64_t total = 0u;
+        for (const auto& segment : segments_) {
+            total += segment.second.size;
+        }
+        return total;
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x4342424d; // "MBBC"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kNoSegment = 0xffffffffu;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t segmentCount;
+        uint64_t entryCount;
+        uint64_t clock;
+        uint32_t nextSegment;
+        uint32_t reserved;
+    };
+
+    struct SegmentRecord {
+        uint32_t id;
+        uint32_t reserved;
+        uint64_t size;
+    };
+
+    struct IndexEntry {
+        uint64_t high;
+        uint64_t low;
+        uint32_t segment;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t access;
+    };
+
+    struct Entry {
+        Entry(uint32_t segment_, uint64_t offset_, uint64_t size_, uint64_t access_)
+            : segment(segment_), offset(offset_), size(size_), access(access_) {}
+
+        uint32_t segment;
+        uint64_t offset;
+        uint64_t size;
+        // Updated by lookups, which only hold a shared lock.
+        mutable std::atomic<uint64_t> access;
+    };
+
+    struct Segment {
+        std::shared_ptr<const internal::BlobSegment> file;
+        uint64_t size;
+        uint64_t live;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const BlobKey& key) const { return static_cast<std::size_t>(key.low ^ key.high); }
+    };
+
+    using Entries = std::unordered_map<BlobKey, Entry, KeyHash>;
+
+    std::string indexPath() const { return directory_ + "/index"; }
+
+    std::string segmentPath(uint32_t id) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/segment-%08x.blob", id);
+        return directory_ + name;
+    }
+
+    bool writable() const {
+#if MB_PLATFORM_IS_WIN32
+        return false;
+#else
+        return !options_.readOnly && static_cast<bool>(lock_);
+#endif
+    }
+
+    expected<void, ErrorType> readOnlyError() const {
+        return make_unexpected(std::string("Blob cache '") + directory_ + std::string("' is not open for writing"));
+    }
+
+    static expected<void, ErrorType> writeError(const std::string& path) {
+        MB_TRACE_COUNTER("io::BlobCache.errors", 1);
+        return make_unexpected(std::string("Failed to write file '") + path + std::string("'"));
+    }
+
+    void reset() {
+        entries_.clear();
+        segments_.clear();
+        index_ = MappedFile();
+        unsynced_.clear();
+        dropped_.clear();
+        bytes_ = 0u;
+        active_ = kNoSegment;
+        nextSegment_ = 0u;
+        clock_ = 0u;
+    }
+
+    const Header& indexHeader() const { return *reinterpret_cast<const Header*>(index_.data()); } // NOLINT
+
+    const IndexEntry* findIndexEntry(const BlobKey& key) const {
+        const auto* begin = reinterpret_cast<const IndexEntry*>(                                      // NOLINT
+            index_.data() + sizeof(Header) + indexHeader().segmentCount * sizeof(SegmentRecord));
+        const auto* end = begin + indexHeader().entryCount;
+        const auto* it = std::lower_bound(begin, end, key, [](const IndexEntry& entry, const BlobKey& k) {
+            return BlobKey{entry.high, entry.low} < k;
+        });
+        return it != end && BlobKey{it->high, it->low} == key ? it : nullptr;
+    }
+
+#if !MB_PLATFORM_IS_WIN32
+    expected<void, ErrorType> load() {
+        const std::string path = indexPath();
+        auto mapped = MappedFile::open(path);
+        if (!mapped) {
+            return expected<void, ErrorType>();
+        }
+
+        const char* data = mapped->data();
+        const std::size_t size = mapped->size();
+        const auto invalid = [&path] {
+            return make_unexpected(std::string("Invalid blob cache index '") + path + std::string("'"));
+        };
+
+        Header header{};
+        if (size < sizeof(Header)) return invalid();
+        std::memcpy(&header, data, sizeof(Header));
+        if (header.magic != kMagic || header.version != kVersion ||
+            header.segmentCount > (size - sizeof(Header)) / sizeof(SegmentRecord) ||
+            header.entryCount != (size - sizeof(Header) - header.segmentCount * sizeof(SegmentRecord)) /
+                                     sizeof(IndexEntry)) {
+            return invalid();
+        }
+
+        for (uint64_t i = 0; i < header.segmentCount; ++i) {
+            SegmentRecord record{};
+            std::memcpy(&record, data + sizeof(Header) + i * sizeof(SegmentRecord), sizeof(SegmentRecord));
+            if (record.id >= header.nextSegment || segments_.count(record.id) != 0u) return invalid();
+
+            const std::string segmentFile = segmentPath(record.id);
+            auto file = internal::BlobSegment::open(segmentFile, static_cast<std::size_t>(record.size), !options_.readOnly);
+            struct stat info {};
+            if (!file || ::fstat(file->fd(), &info) != 0 || static_cast<uint64_t>(info.st_size) < record.size) {
+                return make_unexpected(std::string("Invalid blob cache segment '") + segmentFile + std::string("'"));
+            }
+            // Drops the blobs appended after the last commit.
+            if (!options_.readOnly && static_cast<uint64_t>(info.st_size) > record.size &&
+                ::ftruncate(file->fd(), static_cast<off_t>(record.size)) != 0) {
+                return writeError(segmentFile);
+            }
+            segments_[record.id] = Segment{std::move(file), record.size, 0u};
+        }
+
+        const char* entries = data + sizeof(Header) + header.segmentCount * sizeof(SegmentRecord);
+        BlobKey previous;
+        for (uint64_t i = 0; i < header.entryCount; ++i) {
+            IndexEntry entry{};
+            std::memcpy(&entry, entries + i * sizeof(IndexEntry), sizeof(IndexEntry));
+            const BlobKey key{entry.high, entry.low};
+            const auto segment = segments_.find(entry.segment);
+            if ((i > 0 && !(previous < key)) || segment == segments_.end() || entry.offset > segment->second.size ||
+                entry.size > segment->second.size - entry.offset) {
+                return invalid();
+            }
+            previous = key;
+            segment->second.live += entry.size;
+            bytes_ += entry.size;
+            if (!options_.readOnly) {
+                entries_.emplace(std::piecewise_construct,
+                                 std::forward_as_tuple(key),
+                                 std::forward_as_tuple(entry.segment, entry.offset, entry.size, entry.access));
+            }
+        }
+
+        nextSegment_ = header.nextSegment;
+        clock_ = header.clock;
+        if (options_.readOnly && header.entryCount > 0u) {
+            index_ = std::move(*mapped);
+        }
+        return expected<void, ErrorType>();
+    }
+
+    // Deletes the segment files the index does not refer to, left behind by
+    // a crash, and stale temporary indexes of `writeFileAtomic()`
+    // (`index.XXXXXX`).
+    void removeOrphans() {
+        std::vector<std::string> orphans;
+        WalkOptions walk;
+        walk.recursive = false;
+        walk.stat = false;
+        walkDirectory(directory_, [&](const DirectoryEntry& entry) {
+            const std::string name = entry.path.substr(entry.path.rfind('/') + 1);
+            unsigned id = 0u;
+            char suffix[8] = {};
+            if ((name.size() == 12u && name.compare(0, 6, "index.") == 0) ||
+                (std::sscanf(name.c_str(), "segment-%8x.%5s", &id, suffix) == 2 && std::strcmp(suffix, "blob") == 0 &&
+                 segments_.count(id) == 0u)) {
+                orphans.push_back(entry.path);
+            }
+        });
+        for (const auto& path : orphans) {
+            std::remove(path.c_str());
+        }
+    }
+
+    // Appends a blob to the active segment, starting a new one if it does not
+    // fit, and returns its offset.
+    expected<uint64_t, ErrorType> append(const char* data, std::size_t size) {
+        if (active_ == kNoSegment || segments_.at(active_).size + size > segments_.at(active_).file->capacity()) {
+            const uint32_t id = nextSegment_;
+            const std::string path = segmentPath(id);
+            const auto capacity = static_cast<std::size_t>(std::max<uint64_t>(options_.segmentSize, size));
+            auto file = internal::BlobSegment::open(path, capacity, true);
+            if (!file || ::ftruncate(file->fd(), 0) != 0) {
+                return nonstd::make_unexpected(writeError(path).error());
+            }
+            std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+            segments_[id] = Segment{std::move(file), 0u, 0u};
+            active_ = id;
+            nextSegment_++;
+        }
+
+        // Only the writer touches the active segment size, readers never look
+        // past the blobs in the index.
+        Segment& segment = segments_.at(active_);
+        const uint64_t offset = segment.size;
+        if (!internal::writeAll(segment.file->fd(), data, size, static_cast<off_t>(offset))) {
+            return nonstd::make_unexpected(writeError(segmentPath(active_)).error());
+        }
+        {
+            std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+            segment.size += size;
+        }
+        unsynced_.insert(active_);
+        return offset;
+    }
+
+    // Moves the blobs of the segments less than half full to the active
+    // segment, and drops the empty segments.
+    expected<void, ErrorType> compact() {
+        std::vector<uint32_t> sparse;
+        for (const auto& segment : segments_) {
+            if (segment.first != active_ && segment.second.live * 2 < segment.second.size) {
+                sparse.push_back(segment.first);
+            }
+        }
+
+        for (const uint32_t id : sparse) {
+            const auto source = segments_.at(id).file;
+            std::vector<std::pair<BlobKey, const Entry*>> moved;
+            {
+                std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+                for (const auto& entry : entries_) {
+                    if (entry.second.segment == id) moved.emplace_back(entry.first, &entry.second);
+                }
+            }
+            for (const auto& item : moved) {
+                const Entry& entry = *item.second;
+                auto offset = append(source->data() + entry.offset, static_cast<std::size_t>(entry.size));
+                if (!offset) {
+                    return nonstd::make_unexpected(offset.error());
+                }
+                std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+                auto& mutableEntry = entries_.at(item.first);
+                mutableEntry.segment = active_;
+                mutableEntry.offset = *offset;
+                segments_.at(active_).live += entry.size;
+            }
+
+            std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+            segments_.erase(id);
+            unsynced_.erase(id);
+            dropped_.push_back(id);
+        }
+        return expected<void, ErrorType>();
+    }
+
+    std::string serializeIndex() const {
+        std::vector<std::pair<BlobKey, const Entry*>> sorted;
+        sorted.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            sorted.emplace_back(entry.first, &entry.second);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const std::pair<BlobKey, const Entry*>& a,
+                                                   const std::pair<BlobKey, const Entry*>& b) {
+            return a.first < b.first;
+        });
+
+        std::string out;
+        out.reserve(sizeof(Header) + segments_.size() * sizeof(SegmentRecord) + sorted.size() * sizeof(IndexEntry));
+        const Header header{kMagic, kVersion, segments_.size(), sorted.size(), clock_, nextSegment_, 0u};
+        out.append(reinterpret_cast<const char*>(&header), sizeof(Header)); // NOLINT
+        for (const auto& segment : segments_) {
+            const SegmentRecord record{segment.first, 0u, segment.second.size};
+            out.append(reinterpret_cast<const char*>(&record), sizeof(SegmentRecord)); // NOLINT
+        }
+        for (const auto& item : sorted) {
+            const Entry& entry = *item.second;
+            const IndexEntry record{
+                item.first.high, item.first.low, entry.segment, 0u, entry.offset, entry.size, entry.access.load()};
+            out.append(reinterpret_cast<const char*>(&record), sizeof(IndexEntry)); // NOLINT
+        }
+        return out;
+    }
+#endif
+
+    void release(Entries::iterator it) {
+        segments_.at(it->second.segment).live -= it->second.size;
+        bytes_ -= it->second.size;
+        entries_.erase(it);
+    }
+
+    // Evicts the least recently used blobs down to 90% of the budget, so
+    // that eviction does not run on every insertion.
+    void evict() {
+        if (bytes_ <= options_.maxBytes) return;
+        std::vector<std::pair<uint64_t, BlobKey>> lru;
+        lru.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            lru.emplace_back(entry.second.access.load(), entry.first);
+        }
+        std::sort(lru.begin(), lru.end(), [](const std::pair<uint64_t, BlobKey>& a,
+                                             const std::pair<uint64_t, BlobKey>& b) { return a.first < b.first; });
+        const uint64_t target = options_.maxBytes - options_.maxBytes / 10;
+        for (const auto& item : lru) {
+            if (bytes_ <= target) break;
+            release(entries_.find(item.second));
+        }
+        MB_TRACE_COUNTER("io::BlobCache.evictions", 1);
+    }
+
+    const std::string directory_;
+    const BlobCacheOptions options_;
+
+    // Serializes the writing methods.
+    std::mutex writerMutex_;
+    // Guards the entries and the segment table.
+    mutable std::shared_timed_mutex mutex_;
+#if !MB_PLATFORM_IS_WIN32
+    internal::FileDescriptor lock_{-1};
+#endif
+    Entries entries_;
+    std::map<uint32_t, Segment> segments_;
+    MappedFile index_;
+    std::set<uint32_t> unsynced_;
+    std::vector<uint32_t> dropped_;
+    uint64_t bytes_ = 0u;
+    uint32_t active_ = kNoSegment;
+    uint32_t nextSegment_ = 0u;
+    mutable std::atomic<uint64_t> clock_{0u};
+};
+
+} // namespace io
+} // namespace base
+} // namespace mapbox
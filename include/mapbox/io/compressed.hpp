@@ -0,0 +1,433 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mapbox/io/io.hpp"
+#include "mapbox/io/mapped_file.hpp"
+#include "mapbox/platform.hpp"
+#include "mapbox/util/expected.hpp"
+#include "mapbox/util/scheduler.hpp"
+#include "mapbox/util/trace.hpp"
+
+/**
+ * Enable the codecs of the functions below, which then need to be linked
+ * with zlib and libzstd (see the `MAPBOX_BASE_WITH_ZLIB` and
+ * `MAPBOX_BASE_WITH_ZSTD` CMake options). Without them, only uncompressed
+ * files are supported.
+ */
+#ifndef MB_IO_ZLIB
+#    define MB_IO_ZLIB 0
+#endif
+#ifndef MB_IO_ZSTD
+#    define MB_IO_ZSTD 0
+#endif
+
+#if !MB_PLATFORM_IS_WIN32
+#    include <sys/mman.h>
+#endif
+#if MB_IO_ZLIB
+#    include <zlib.h>
+#endif
+#if MB_IO_ZSTD
+#    include <zstd.h>
+#endif
+
+namespace mapbox {
+namespace base {
+namespace io {
+
+/**
+ * @brief Compression format of a file.
+ */
+enum class Codec : uint8_t {
+    /// Not compressed.
+    None,
+    /// Deflate, in a gzip stream.
+    Deflate,
+    /// Zstandard.
+    Zstd,
+};
+
+/**
+ * @brief Options of \c writeCompressedFile().
+ */
+struct CompressionOptions {
+#if MB_IO_ZSTD
+    Codec codec = Codec::Zstd;
+#elif MB_IO_ZLIB
+    Codec codec = Codec::Deflate;
+#else
+    Codec codec = Codec::None;
+#endif
+
+    /// Compression level, `-1` meaning the codec default.
+    int level = -1;
+
+    /// Number of threads compressing the data. Deflate streams are then
+    /// compressed in independent chunks, zstd frames by the library
+    /// workers, if built with multithreading support.
+    std::size_t threads = 1;
+
+    /// Scheduler running the deflate chunks when \c threads is more than
+    /// one, \c Scheduler::shared() if null. At most \c threads of its
+    /// workers are used.
+    Scheduler* scheduler = nullptr;
+};
+
+/**
+ * @brief Detects the codec of compressed data from its magic bytes.
+ *
+ * @return \c Codec::None if the data is not compressed with a known codec.
+ */
+inline Codec detectCodec(const char* data, std::size_t size) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data); // NOLINT cppcoreguidelines-pro-type-reinterpret-cast
+    if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd) {
+        return Codec::Zstd;
+    }
+    // Headerless zlib streams are not detected, their two byte header also
+    // starts plain text like "80" or "hb".
+    if (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) {
+        return Codec::Deflate;
+    }
+    return Codec::None;
+}
+
+/// @cond internal
+namespace internal {
+
+// Caps size hints read from corrupted headers. Data may still decompress to
+// more, the output then grows as needed.
+inline std::size_t capHint(uint64_t hint, std::size_t compressedSize) {
+    return static_cast<std::size_t>(std::min<uint64_t>(hint, uint64_t{compressedSize} * 1032u + 65536u));
+}
+
+// Grows `out` geometrically once its free space is used up, and returns the
+// free space.
+inline std::size_t growOutput(std::string& out, std::size_t used, std::size_t hint = 0) {
+    if (out.size() - used < 4096) {
+        out.resize(std::max({out.size() * 2, used + 65536, hint}));
+    }
+    return out.size() - used;
+}
+
+#if MB_IO_ZLIB
+// zlib counts bytes in `uInt`, inputs are fed in chunks.
+constexpr std::size_t kZlibChunk = std::size_t{1} << 30;
+
+inline bool inflateTo(const char* data, std::size_t size, std::string& out) {
+    // The gzip trailer holds the uncompressed size modulo 2^32.
+    std::size_t hint = 0;
+    if (size >= 18 && static_cast<uint8_t>(data[0]) == 0x1f) {
+        uint32_t isize = 0;
+        for (int i = 3; i >= 0; --i) {
+            isize = (isize << 8) | static_cast<uint8_t>(data[size - 4 + i]);
+        }
+        hint = capHint(isize, size);
+    }
+
+    z_stream stream{};
+    if (inflateInit2(&stream, 15 + 16) != Z_OK) return false;
+
+    std::size_t consumed = 0;
+    std::size_t produced = 0;
+    out.resize(std::max<std::size_t>(hint, 65536));
+    int ret = Z_OK;
+    while (true) {
+        if (stream.avail_in == 0 && consumed < size) {
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + consumed)); // NOLINT
+            stream.avail_in = static_cast<uInt>(std::min(size - consumed, kZlibChunk));
+            consumed += stream.avail_in;
+        }
+        const std::size_t available = std::min(growOutput(out, produced), kZlibChunk);
+        stream.next_out = reinterpret_cast<Bytef*>(&out[produced]); // NOLINT
+        stream.avail_out = static_cast<uInt>(available);
+
+        ret = inflate(&stream, Z_NO_FLUSH);
+        produced += available - stream.avail_out;
+        if (ret == Z_STREAM_END) {
+            // Concatenated gzip members decompress to the concatenated data.
+            if (stream.avail_in == 0 && consumed == size) break;
+            if (inflateReset(&stream) != Z_OK) break;
+            continue;
+        }
+        if (ret != Z_OK && !(ret == Z_BUF_ERROR && stream.avail_out == 0)) break;
+        if (ret == Z_OK && stream.avail_in == 0 && consumed == size && stream.avail_out != 0) {
+            ret = Z_DATA_ERROR; // Truncated stream.
+            break;
+        }
+    }
+    inflateEnd(&stream);
+    out.resize(produced);
+    return ret == Z_STREAM_END;
+}
+
+// Deflates `size` bytes to `out`, as raw deflate blocks (`windowBits`
+// negative) or a gzip stream. Non-final chunks end with a sync flush, so
+// that chunks compressed separately can be concatenated.
+inline bool deflateTo(const char* data,
+                      std::size_t size,
+                      int level,
+                      int windowBits,
+                      bool last,
+                      const char* dictionary,
+                      std::size_t dictionarySize,
+                      std::string& out) {
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+    if (dictionarySize > 0 && deflateSetDictionary(&stream,
+                                                   reinterpret_cast<const Bytef*>(dictionary), // NOLINT
+                                                   static_cast<uInt>(dictionarySize)) != Z_OK) {
+        deflateEnd(&stream);
+        return false;
+    }
+
+    std::size_t consumed = 0;
+    std::size_t produced = 0;
+    out.resize(deflateBound(&stream, static_cast<uLong>(std::min(size, kZlibChunk))) + 64);
+    int ret = Z_OK;
+    while (true) {
+        if (stream.avail_in == 0 && consumed < size) {
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + consumed)); // NOLINT
+            stream.avail_in = static_cast<uInt>(std::min(size - consumed, kZlibChunk));
+            consumed += stream.avail_in;
+        }
+        const int flush = consumed < size ? Z_NO_FLUSH : (last ? Z_FINISH : Z_SYNC_FLUSH);
+        const std::size_t available = std::min(growOutput(out, produced), kZlibChunk);
+        stream.next_out = reinterpret_cast<Bytef*>(&out[produced]); // NOLINT
+        stream.avail_out = static_cast<uInt>(available);
+
+        ret = deflate(&stream, flush);
+        produced += available - stream.avail_out;
+        if (ret == Z_STREAM_END) break;
+        if (ret != Z_OK && ret != Z_BUF_ERROR) break;
+        if (flush == Z_SYNC_FLUSH && stream.avail_in == 0 && stream.avail_out != 0) {
+            ret = Z_STREAM_END;
+            break;
+        }
+    }
+    deflateEnd(&stream);
+    out.resize(produced);
+    return ret == Z_STREAM_END;
+}
+
+// Writes a gzip stream compressed in chunks on several threads, like pigz:
+// each chunk is a run of deflate blocks primed with the end of the previous
+// chunk, and their check sums are combined.
+inline bool parallelGzip(const char* data, std::size_t size, const CompressionOptions& options, std::string& out) {
+    constexpr std::size_t kChunkSize = std::size_t{1} << 20;
+    constexpr std::size_t kDictionarySize = 32768;
+    const std::size_t chunks = std::max<std::size_t>(1u, (size + kChunkSize - 1) / kChunkSize);
+
+    std::vector<std::string> compressed(chunks);
+    std::vector<uLong> checksums(chunks);
+    std::vector<char> ok(chunks, 0);
+    const auto compress = [&](std::size_t i) {
+        const std::size_t begin = i * kChunkSize;
+        const std::size_t length = std::min(kChunkSize, size - begin);
+        const std::size_t dictionary = std::min(begin, kDictionarySize);
+        ok[i] = deflateTo(data + begin,
+                          length,
+                          options.level,
+                          -15,
+                          i + 1 == chunks,
+                          data + begin - dictionary,
+                          dictionary,
+                          compressed[i]);
+        checksums[i] = crc32(0L, reinterpret_cast<const Bytef*>(data + begin), static_cast<uInt>(length)); // NOLINT
+    };
+    // At most `threads` chunks are compressed at a time, whatever the size
+    // of the scheduler: worker `w` takes chunks w, w + workers, ...
+    const std::size_t workers = std::min(options.threads, chunks);
+    Scheduler& scheduler = options.scheduler ? *options.scheduler : Scheduler::shared();
+    parallelFor(scheduler, 0, workers, [&](std::size_t worker) {
+        for (std::size_t i = worker; i < chunks; i += workers) {
+            compress(i);
+        }
+    });
+    if (std::find(ok.begin(), ok.end(), 0) != ok.end()) return false;
+
+    uLong checksum = crc32(0L, Z_NULL, 0);
+    std::size_t total = 18;
+    for (std::size_t i = 0; i < chunks; ++i) {
+        const std::size_t length = std::min(kChunkSize, size - i * kChunkSize);
+        checksum = crc32_combine(checksum, checksums[i], static_cast<z_off_t>(length));
+        total += compressed[i].size();
+    }
+
+    const auto appendLE = [&out](uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out += static_cast<char>((value >> (i * 8)) & 0xff);
+        }
+    };
+    out.clear();
+    out.reserve(total);
+    // Header: magic, deflate, no flags, no time, no extra flags, unknown OS.
+    out.append("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+    for (const auto& chunk : compressed) {
+        out += chunk;
+    }
+    appendLE(static_cast<uint32_t>(checksum));
+    appendLE(static_cast<uint32_t>(size));
+    return true;
+}
+#endif
+
+#if MB_IO_ZSTD
+inline bool zstdDecompressTo(const char* data, std::size_t size, std::string& out) {
+    const unsigned long long contentSize = ZSTD_getFrameContentSize(data, size);
+    std::size_t hint = 0;
+    if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR) {
+        hint = capHint(contentSize, size);
+    }
+
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    if (!stream) return false;
+    ZSTD_initDStream(stream);
+
+    ZSTD_inBuffer input{data, size, 0};
+    std::size_t produced = 0;
+    std::size_t ret = 0;
+    out.resize(std::max<std::size_t>(hint, 65536));
+    while (input.pos < input.size) {
+        ZSTD_outBuffer output{&out[0], out.size(), produced};
+        ret = ZSTD_decompressStream(stream, &output, &input);
+        produced = output.pos;
+        if (ZSTD_isError(ret)) break;
+        growOutput(out, produced);
+    }
+    // Flushes the data the decoder still holds.
+    while (!ZSTD_isError(ret) && ret != 0) {
+        growOutput(out, produced);
+        ZSTD_outBuffer output{&out[0], out.size(), produced};
+        const std::size_t before = produced;
+        ret = ZSTD_decompressStream(stream, &output, &input);
+        produced = output.pos;
+        if (produced == before) break; // Truncated frame.
+    }
+    ZSTD_freeDStream(stream);
+    out.resize(produced);
+    return !ZSTD_isError(ret) && ret == 0;
+}
+
+inline bool zstdCompressTo(const char* data, std::size_t size, const CompressionOptions& options, std::string& out) {
+    ZSTD_CCtx* context = ZSTD_createCCtx();
+    if (!context) return false;
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, options.level < 0 ? ZSTD_CLEVEL_DEFAULT : options.level);
+    if (options.threads > 1) {
+        // Fails, leaving compression single-threaded, if the library was
+        // built without multithreading support.
+        ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, static_cast<int>(options.threads));
+    }
+    out.resize(ZSTD_compressBound(size));
+    const std::size_t ret = ZSTD_compress2(context, &out[0], out.size(), data, size);
+    ZSTD_freeCCtx(context);
+    if (ZSTD_isError(ret)) return false;
+    out.resize(ret);
+    return true;
+}
+#endif
+
+inline bool decompressTo(Codec codec, const char* data, std::size_t size, std::string& out) {
+    switch (codec) {
+        case Codec::None:
+            out.assign(data, size);
+            return true;
+#if MB_IO_ZLIB
+        case Codec::Deflate:
+            return inflateTo(data, size, out);
+#endif
+#if MB_IO_ZSTD
+        case Codec::Zstd:
+            return zstdDecompressTo(data, size, out);
+#endif
+        default:
+            return false;
+    }
+}
+
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Reads and decompresses \a filename, detecting the codec from its
+ * magic bytes.
+ *
+ * The file is mapped and decompressed straight into the returned string,
+ * without reading the compressed data into a buffer first. gzip and zstd
+ * files are recognized, others are returned as is.
+ *
+ * @return an error if the file cannot be read, or is compressed with a
+ * codec that is not enabled or is corrupted.
+ */
+inline expected<std::string, ErrorType> readCompressedFile(const std::string& filename) {
+    MB_TRACE_SCOPE("io::readCompressedFile");
+    auto mapped = MappedFile::open(filename);
+    if (!mapped) {
+        MB_TRACE_COUNTER("io::readCompressedFile.errors", 1);
+        return make_unexpected(std::string("Failed to read file '") + filename + std::string("'"));
+    }
+#if !MB_PLATFORM_IS_WIN32
+    if (!mapped->empty()) {
+        // Pages are read ahead while the start of the file is decoded.
+        ::madvise(const_cast<char*>(mapped->data()), mapped->size(), MADV_SEQUENTIAL); // NOLINT
+    }
+#endif
+
+    std::string contents;
+    const Codec codec = detectCodec(mapped->data(), mapped->size());
+    if (!internal::decompressTo(codec, mapped->data(), mapped->size(), contents)) {
+        MB_TRACE_COUNTER("io::readCompressedFile.errors", 1);
+        return make_unexpected(std::string("Failed to decompress file '") + filename + std::string("'"));
+    }
+    MB_TRACE_HISTOGRAM("io::readCompressedFile.bytes", static_cast<double>(contents.size()));
+    return expected<std::string, ErrorType>(std::move(contents));
+}
+
+/**
+ * @brief Compresses \a data and writes it to \a filename.
+ *
+ * @return an error if the codec is not enabled or the file cannot be
+ * written.
+ */
+inline expected<void, ErrorType> writeCompressedFile(const std::string& filename,
+                                                     const std::string& data,
+                                                     const CompressionOptions& options = {}) {
+    MB_TRACE_SCOPE("io::writeCompressedFile");
+    std::string compressed;
+    bool ok = false;
+    switch (options.codec) {
+        case Codec::None:
+            return writeFile(filename, data);
+#if MB_IO_ZLIB
+        case Codec::Deflate:
+            if (options.threads > 1 && data.size() > (std::size_t{1} << 20)) {
+                ok = internal::parallelGzip(data.data(), data.size(), options, compressed);
+            } else {
+                ok = internal::deflateTo(
+                    data.data(), data.size(), options.level, 15 + 16, true, nullptr, 0u, compressed);
+            }
+            break;
+#endif
+#if MB_IO_ZSTD
+        case Codec::Zstd:
+            ok = internal::zstdCompressTo(data.data(), data.size(), options, compressed);
+            break;
+#endif
+        default:
+            break;
+    }
+    if (!ok) {
+        MB_TRACE_COUNTER("io::writeCompressedFile.errors", 1);
+        return make_unexpected(std::string("Failed to compress file '") + filename + std::string("'"));
+    }
+    return writeFile(filename, compressed);
+}
+
+} // namespace io
+} // namespace base
+} // namespace mapbox
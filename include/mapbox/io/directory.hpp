@@ -0,0 +1,331 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mapbox/io/io.hpp"
+#include "mapbox/platform.hpp"
+#include "mapbox/util/expected.hpp"
+#include "mapbox/util/scheduler.hpp"
+#include "mapbox/util/trace.hpp"
+
+#if !MB_PLATFORM_IS_WIN32
+#    include <dirent.h>
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    if MB_PLATFORM_IS_LINUX || MB_PLATFORM_IS_ANDROID
+#        include <sys/syscall.h>
+#    endif
+#endif
+
+namespace mapbox {
+namespace base {
+namespace io {
+
+/**
+ * @brief Type of a \c DirectoryEntry.
+ */
+enum class EntryType : uint8_t { File, Directory, Symlink, Other };
+
+/**
+ * @brief File found by \c walkDirectory().
+ */
+struct DirectoryEntry {
+    /// Path of the file, starting with the walked directory.
+    std::string path;
+    EntryType type = EntryType::Other;
+    /// Size in bytes, if stats were requested.
+    uint64_t size = 0u;
+    /// Last modification time, if stats were requested.
+    std::chrono::system_clock::time_point modified;
+};
+
+/**
+ * @brief Options of \c walkDirectory().
+ */
+struct WalkOptions {
+    /// Walks the subdirectories too.
+    bool recursive = true;
+
+    /// Fills \c DirectoryEntry::size and \c DirectoryEntry::modified, which
+    /// costs an `fstatat()` call per entry.
+    bool stat = true;
+
+    /// Walks subdirectories in parallel on this scheduler. The callback is
+    /// then called concurrently from its worker threads and the calling
+    /// thread.
+    Scheduler* scheduler = nullptr;
+};
+
+/// @cond internal
+namespace internal {
+
+#if !MB_PLATFORM_IS_WIN32
+
+struct WalkState {
+    explicit WalkState(const WalkOptions& options_) : options(options_) {}
+
+    const WalkOptions options;
+    std::atomic_size_t pending{0u};
+    std::atomic_bool stopped{false};
+    std::mutex mutex;
+    std::string error;
+    std::exception_ptr exception;
+
+    void fail(std::string message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error.empty()) error = std::move(message);
+    }
+
+    void stop(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!exception) exception = std::move(e);
+        stopped = true;
+    }
+};
+
+inline EntryType entryType(mode_t mode) {
+    if (S_ISREG(mode)) return EntryType::File;
+    if (S_ISDIR(mode)) return EntryType::Directory;
+    if (S_ISLNK(mode)) return EntryType::Symlink;
+    return EntryType::Other;
+}
+
+inline EntryType entryType(unsigned char type) {
+    switch (type) {
+        case DT_REG:
+            return EntryType::File;
+        case DT_DIR:
+            return EntryType::Directory;
+        case DT_LNK:
+            return EntryType::Symlink;
+        default:
+            return EntryType::Other;
+    }
+}
+
+inline std::string joinPath(const std::string& directory, const char* name) {
+    std::string path = directory;
+    if (path.empty() || path.back() != '/') path += '/';
+    return path += name;
+}
+
+inline FileDescriptor openDirectory(int parent, const char* name) {
+    int fd;
+    do {
+        fd = ::openat(parent, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    return FileDescriptor(fd);
+}
+
+// Calls `fn(name, type)` for the entries of the directory `fd`, `type` being
+// `DT_UNKNOWN` when the file system does not report it.
+template <typename Fn>
+bool readDirectory(int fd, Fn&& fn) {
+#    if MB_PLATFORM_IS_LINUX || MB_PLATFORM_IS_ANDROID
+    // Reads entries in large batches with the raw syscall, which `readdir()`
+    // does with a small buffer.
+    struct Dirent64 {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+    alignas(Dirent64) char buffer[32768];
+    while (true) {
+        const long count = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (count == 0) return true;
+        for (long offset = 0; offset < count;) {
+            const auto* entry = reinterpret_cast<const Dirent64*>(buffer + offset); // NOLINT
+            fn(entry->d_name, entry->d_type);
+            offset += entry->d_reclen;
+        }
+    }
+#    else
+    // `closedir()` closes the descriptor it was opened from.
+    const int copy = ::dup(fd);
+    if (copy < 0) return false;
+    DIR* dir = ::fdopendir(copy);
+    if (!dir) {
+        ::close(copy);
+        return false;
+    }
+    errno = 0;
+    while (const dirent* entry = ::readdir(dir)) {
+        fn(entry->d_name, entry->d_type);
+        errno = 0;
+    }
+    const bool ok = errno == 0;
+    ::closedir(dir);
+    return ok;
+#    endif
+}
+
+template <typename Fn>
+void walk(const std::shared_ptr<WalkState>& state, const Fn& callback, int fd, const std::string& path) {
+    std::vector<std::string> subdirectories;
+    DirectoryEntry entry;
+    entry.path = joinPath(path, "");
+    const std::size_t prefix = entry.path.size();
+
+    const bool ok = readDirectory(fd, [&](const char* name, unsigned char type) {
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) return;
+        if (state->stopped) return;
+
+        entry.path.resize(prefix);
+        entry.path += name;
+        entry.type = entryType(type);
+        entry.size = 0u;
+        entry.modified = {};
+        if (state->options.stat || type == DT_UNKNOWN) {
+            struct stat info {};
+            if (::fstatat(fd, name, &info, AT_SYMLINK_NOFOLLOW) != 0) {
+                // The file was removed since the directory was read.
+                if (errno != ENOENT) {
+                    state->fail(std::string("Failed to stat file '") + entry.path + std::string("'"));
+                }
+                return;
+            }
+            entry.type = entryType(info.st_mode);
+            if (state->options.stat) {
+                entry.size = static_cast<uint64_t>(info.st_size);
+#    if MB_PLATFORM_IS_MAC || MB_PLATFORM_IS_IOS
+                const timespec& mtime = info.st_mtimespec;
+#    else
+                const timespec& mtime = info.st_mtim;
+#    endif
+                entry.modified = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                        std::chrono::seconds(mtime.tv_sec) + std::chrono::nanoseconds(mtime.tv_nsec)));
+            }
+        }
+
+        callback(static_cast<const DirectoryEntry&>(entry));
+
+        if (entry.type == EntryType::Directory && state->options.recursive) {
+            subdirectories.push_back(name);
+        }
+    });
+    if (!ok) {
+        state->fail(std::string("Failed to read directory '") + path + std::string("'"));
+    }
+
+    for (const std::string& name : subdirectories) {
+        if (state->stopped) return;
+        const std::string subpath = joinPath(path, name.c_str());
+        if (state->options.scheduler) {
+            // Subdirectories are reopened by path from the tasks, so that
+            // queued tasks do not hold descriptors.
+            state->pending++;
+            state->options.scheduler->schedule([state, &callback, subpath] {
+                try {
+                    const auto sub = FileDescriptor::open(subpath, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+                    if (sub) {
+                        walk(state, callback, sub.get(), subpath);
+                    } else if (errno != ENOENT) {
+                        state->fail(std::string("Failed to read directory '") + subpath + std::string("'"));
+                    }
+                } catch (...) {
+                    state->stop(std::current_exception());
+                }
+                state->pending--;
+            });
+        } else {
+            const auto sub = openDirectory(fd, name.c_str());
+            if (sub) {
+                walk(state, callback, sub.get(), subpath);
+            } else if (errno != ENOENT) {
+                state->fail(std::string("Failed to read directory '") + subpath + std::string("'"));
+            }
+        }
+    }
+}
+
+#endif
+
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Calls \a callback with a `const DirectoryEntry&` for every file in
+ * the directory \a path, and in its subdirectories unless disabled by
+ * \a options.
+ *
+ * Entries are streamed in directory order, a directory being reported
+ * before its contents. Directories are read relative to their descriptor
+ * (with `getdents64()` on Linux and Android) and files are stat'ed with
+ * `fstatat()`, so paths are not resolved again for every file. Symbolic
+ * links are reported but not followed.
+ *
+ * Unreadable subdirectories and files are skipped and the walk goes on.
+ * Files and subdirectories removed while the walk runs are skipped without
+ * an error. If \a callback throws, the exception is rethrown once the walk
+ * stopped.
+ *
+ * Not implemented on Windows, where an error is returned.
+ *
+ * @return an error if \a path cannot be read, or naming the first file or
+ * subdirectory that could not be read.
+ */
+template <typename Fn>
+expected<void, ErrorType> walkDirectory(const std::string& path, const Fn& callback, const WalkOptions& options = {}) {
+    MB_TRACE_SCOPE("io::walkDirectory");
+#if MB_PLATFORM_IS_WIN32
+    (void)callback;
+    (void)options;
+    return make_unexpected(std::string("Failed to read directory '") + path + std::string("'"));
+#else
+    const auto fd = internal::FileDescriptor::open(path, O_RDONLY | O_DIRECTORY);
+    if (!fd) {
+        MB_TRACE_COUNTER("io::walkDirectory.errors", 1);
+        return make_unexpected(std::string("Failed to read directory '") + path + std::string("'"));
+    }
+
+    auto state = std::make_shared<internal::WalkState>(options);
+    std::string root = path;
+    while (root.size() > 1 && root.back() == '/') {
+        root.pop_back();
+    }
+    try {
+        internal::walk(state, callback, fd.get(), root);
+    } catch (...) {
+        // Scheduled tasks refer to the callback, wait for them before
+        // rethrowing.
+        state->stop(std::current_exception());
+    }
+
+    while (state->pending > 0) {
+        if (!options.scheduler->runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+    if (!state->error.empty()) {
+        MB_TRACE_COUNTER("io::walkDirectory.errors", 1);
+        return make_unexpected(std::string(state->error));
+    }
+    return expected<void, ErrorType>();
+#endif
+}
+
+} // namespace io
+} // namespace base
+} // namespace mapbox
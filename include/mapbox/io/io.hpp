@@ -1,10 +1,46 @@
 #pragma once
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <string>
+#include <type_traits>
+#include <utility>
 
+#include "mapbox/platform.hpp"
 #include "mapbox/util/expected.hpp"
+#include "mapbox/util/trace.hpp"
+
+/**
+ * Selects the iostream implementation of the functions below instead of the
+ * POSIX one, which reads and writes with `pread()` and `pwrite()`. Always
+ * enabled on Windows.
+ */
+#ifndef MB_IO_USE_IOSTREAM
+#    if MB_PLATFORM_IS_WIN32
+#        define MB_IO_USE_IOSTREAM 1
+#    else
+#        define MB_IO_USE_IOSTREAM 0
+#    endif
+#endif
+
+#if MB_IO_USE_IOSTREAM
+#    include <fstream>
+#endif
+#if MB_PLATFORM_IS_WIN32
+#    include <io.h>
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <sys/types.h>
+#    include <unistd.h>
+#endif
 
 namespace mapbox {
 namespace base {
@@ -12,31 +48,178 @@ namespace io {
 
 using ErrorType = std::string;
 
-inline expected<std::string, ErrorType> readFile(const std::string& filename) {
+#if !MB_PLATFORM_IS_WIN32
+/// @cond internal
+namespace internal {
+
+/**
+ * @brief Owns a file descriptor.
+ */
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd) noexcept : fd_(fd) {}
+    FileDescriptor(FileDescriptor&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+    FileDescriptor& operator=(FileDescriptor&& other) noexcept {
+        if (this != &other) {
+            close();
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+    ~FileDescriptor() { close(); }
+
+    static FileDescriptor open(const std::string& filename, int flags, mode_t mode = 0) {
+        int fd;
+        do {
+            fd = ::open(filename.c_str(), flags | O_CLOEXEC, mode);
+        } while (fd < 0 && errno == EINTR);
+        return FileDescriptor(fd);
+    }
+
+    int get() const noexcept { return fd_; }
+    explicit operator bool() const noexcept { return fd_ >= 0; }
+
+    bool close() noexcept {
+        if (fd_ < 0) return true;
+        const int ret = ::close(fd_);
+        fd_ = -1;
+        return ret == 0;
+    }
+
+private:
+    int fd_;
+};
+
+// Reads up to `size` bytes at `offset`, retrying interrupted calls. Falls
+// back to `read()` on descriptors that cannot seek, like pipes.
+inline ssize_t readAt(int fd, char* data, std::size_t size, off_t offset) {
+    ssize_t count;
+    do {
+        count = ::pread(fd, data, size, offset);
+        if (count < 0 && errno == ESPIPE) {
+            count = ::read(fd, data, size);
+        }
+    } while (count < 0 && errno == EINTR);
+    return count;
+}
+
+// Reads `fd` until the end of the file, appending to `contents`.
+template <typename String>
+bool readAll(int fd, String& contents) {
+    struct stat info {};
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        contents.reserve(static_cast<std::size_t>(info.st_size));
+    }
+
+    // The file size is only a hint, the file may change while being read.
+    std::size_t offset = 0u;
+    char buffer[16384];
+    while (true) {
+        if (contents.capacity() > offset) {
+            contents.resize(contents.capacity());
+            const ssize_t count = readAt(fd, &contents[offset], contents.size() - offset, static_cast<off_t>(offset));
+            if (count < 0) return false;
+            contents.resize(offset + static_cast<std::size_t>(count));
+            if (count == 0) return true;
+            offset += static_cast<std::size_t>(count);
+        } else {
+            const ssize_t count = readAt(fd, buffer, sizeof(buffer), static_cast<off_t>(offset));
+            if (count < 0) return false;
+            if (count == 0) return true;
+            contents.append(buffer, static_cast<std::size_t>(count));
+            offset += static_cast<std::size_t>(count);
+        }
+    }
+}
+
+// Writes all of `data` at `offset`, retrying short and interrupted writes.
+inline bool writeAll(int fd, const char* data, std::size_t size, off_t offset = 0) {
+    while (size > 0) {
+        ssize_t count = ::pwrite(fd, data, size, offset);
+        if (count < 0 && errno == ESPIPE) {
+            count = ::write(fd, data, size);
+        }
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+        offset += count;
+    }
+    return true;
+}
+
+} // namespace internal
+/// @endcond
+#endif
+
+/**
+ * @brief Reads \a filename into a string allocated with \a allocator, for
+ * example a \c PolymorphicAllocator backed by an arena.
+ */
+template <typename Allocator>
+expected<std::basic_string<char, std::char_traits<char>, Allocator>, ErrorType> readFile(const std::string& filename,
+                                                                                       const Allocator& allocator) {
+    using String = std::basic_string<char, std::char_traits<char>, Allocator>;
+    MB_TRACE_SCOPE("io::readFile");
+    String contents(allocator);
+#if MB_IO_USE_IOSTREAM
     std::ifstream file(filename, std::ios::binary);
     if (!file.good()) {
+        MB_TRACE_COUNTER("io::readFile.errors", 1);
+        return make_unexpected(std::string("Failed to read file '") + filename + std::string("'"));
+    }
+
+    char buffer[16384];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        contents.append(buffer, static_cast<std::size_t>(file.gcount()));
+    }
+#else
+    const auto file = internal::FileDescriptor::open(filename, O_RDONLY);
+    if (!file || !internal::readAll(file.get(), contents)) {
+        MB_TRACE_COUNTER("io::readFile.errors", 1);
         return make_unexpected(std::string("Failed to read file '") + filename + std::string("'"));
     }
+#endif
+
+    MB_TRACE_HISTOGRAM("io::readFile.bytes", static_cast<double>(contents.size()));
+    return expected<String, ErrorType>(std::move(contents));
+}
 
-    std::stringstream data;
-    data << file.rdbuf();
-    return expected<std::string, ErrorType>(data.str());
+inline expected<std::string, ErrorType> readFile(const std::string& filename) {
+    return readFile(filename, std::allocator<char>());
 }
 
 inline expected<void, ErrorType> writeFile(const std::string& filename, const std::string& data) {
+    MB_TRACE_SCOPE("io::writeFile");
+    MB_TRACE_HISTOGRAM("io::writeFile.bytes", static_cast<double>(data.size()));
+#if MB_IO_USE_IOSTREAM
     std::ofstream file(filename, std::ios::binary);
     if (!file.good()) {
+        MB_TRACE_COUNTER("io::writeFile.errors", 1);
         return make_unexpected(std::string("Failed to write file '") + filename + std::string("'"));
     }
 
     file << data;
+#else
+    auto file = internal::FileDescriptor::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (!file || !internal::writeAll(file.get(), data.data(), data.size()) || !file.close()) {
+        MB_TRACE_COUNTER("io::writeFile.errors", 1);
+        return make_unexpected(std::string("Failed to write file '") + filename + std::string("'"));
+    }
+#endif
 
     return expected<void, ErrorType>();
 }
 
 inline expected<void, ErrorType> deleteFile(const std::string& filename) {
+    MB_TRACE_SCOPE("io::deleteFile");
     const int ret = std::remove(filename.c_str());
     if (ret != 0) {
+        MB_TRACE_COUNTER("io::deleteFile.errors", 1);
         return make_unexpected(std::string("Failed to delete file '") + filename + std::string("'"));
     }
 
@@ -44,12 +227,196 @@ inline expected<void, ErrorType> deleteFile(const std::string& filename) {
 }
 
 inline expected<void, ErrorType> copyFile(const std::string& sourcePath, const std::string& destinationPath) {
+    MB_TRACE_SCOPE("io::copyFile");
+#if MB_IO_USE_IOSTREAM
     auto contents = readFile(sourcePath);
     if (!contents) {
         return nonstd::make_unexpected(contents.error());
     }
 
     return writeFile(destinationPath, *contents);
+#else
+    // Copies in chunks, without holding the whole file in memory.
+    const auto source = internal::FileDescriptor::open(sourcePath, O_RDONLY);
+    if (!source) {
+        MB_TRACE_COUNTER("io::copyFile.errors", 1);
+        return make_unexpected(std::string("Failed to read file '") + sourcePath + std::string("'"));
+    }
+    // Truncated only once known not to be the source, which may be the
+    // same path or a link to it.
+    auto destination = internal::FileDescriptor::open(destinationPath, O_WRONLY | O_CREAT, 0666);
+    if (!destination) {
+        MB_TRACE_COUNTER("io::copyFile.errors", 1);
+        return make_unexpected(std::string("Failed to write file '") + destinationPath + std::string("'"));
+    }
+    struct stat sourceInfo {};
+    struct stat destinationInfo {};
+    if (::fstat(source.get(), &sourceInfo) != 0 || ::fstat(destination.get(), &destinationInfo) != 0) {
+        MB_TRACE_COUNTER("io::copyFile.errors", 1);
+        return make_unexpected(std::string("Failed to write file '") + destinationPath + std::string("'"));
+    }
+    if (sourceInfo.st_dev == destinationInfo.st_dev && sourceInfo.st_ino == destinationInfo.st_ino) {
+        return expected<void, ErrorType>();
+    }
+    if (::ftruncate(destination.get(), 0) != 0) {
+        MB_TRACE_COUNTER("io::copyFile.errors", 1);
+        return make_unexpected(std::string("Failed to write file '") + destinationPath + std::string("'"));
+    }
+
+    char buffer[65536];
+    off_t offset = 0;
+    while (true) {
+        const ssize_t count = internal::readAt(source.get(), buffer, sizeof(buffer), offset);
+        if (count < 0) {
+            MB_TRACE_COUNTER("io::copyFile.errors", 1);
+            return make_unexpected(std::string("Failed to read file '") + sourcePath + std::string("'"));
+        }
+        if (count == 0) break;
+        if (!internal::writeAll(destination.get(), buffer, static_cast<std::size_t>(count), offset)) {
+            MB_TRACE_COUNTER("io::copyFile.errors", 1);
+            return make_unexpected(std::string("Failed to write file '") + destinationPath + std::string("'"));
+        }
+        offset += count;
+    }
+    if (!destination.close()) {
+        MB_TRACE_COUNTER("io::copyFile.errors", 1);
+        return make_unexpected(std::string("Failed to write file '") + destinationPath + std::string("'"));
+    }
+
+    return expected<void, ErrorType>();
+#endif
+}
+
+/**
+ * @brief Sequential, buffered writer of the file written by
+ * \c writeFileAtomic().
+ */
+class FileWriter {
+public:
+#if MB_PLATFORM_IS_WIN32
+    explicit FileWriter(std::FILE* file) : file_(file) {}
+#else
+    explicit FileWriter(int fd) : fd_(fd) {}
+#endif
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    /**
+     * @brief Appends \a size bytes to the file.
+     *
+     * @return false if the data could not be written.
+     */
+    bool write(const char* data, std::size_t size) {
+        if (buffered_ + size > sizeof(buffer_)) {
+            if (!flush()) return false;
+            // Large writes bypass the buffer.
+            if (size > sizeof(buffer_) / 2) return writeThrough(data, size);
+        }
+        std::copy(data, data + size, buffer_ + buffered_);
+        buffered_ += size;
+        return true;
+    }
+
+    /**
+     * @brief Writes the buffered data to the file.
+     */
+    bool flush() {
+        const std::size_t size = buffered_;
+        buffered_ = 0u;
+        return size == 0u || writeThrough(buffer_, size);
+    }
+
+    /**
+     * @brief Number of bytes written so far.
+     */
+    uint64_t offset() const noexcept { return offset_ + buffered_; }
+
+private:
+    bool writeThrough(const char* data, std::size_t size) {
+#if MB_PLATFORM_IS_WIN32
+        if (std::fwrite(data, 1, size, file_) != size) return false;
+#else
+        if (!internal::writeAll(fd_, data, size, static_cast<off_t>(offset_))) return false;
+#endif
+        offset_ += size;
+        return true;
+    }
+
+#if MB_PLATFORM_IS_WIN32
+    std::FILE* file_;
+#else
+    int fd_;
+#endif
+    uint64_t offset_ = 0u;
+    std::size_t buffered_ = 0u;
+    char buffer_[65536];
+};
+
+/**
+ * @brief Replaces \a filename with the data written by \a fill, a function
+ * taking a \c FileWriter& and returning false on failure.
+ *
+ * The data is written to a uniquely named temporary file next to
+ * \a filename (`filename.XXXXXX`), flushed to disk and then renamed over it,
+ * so that \a filename holds either its old or its new contents, also after
+ * a crash or a power loss and when several threads or processes replace it
+ * at the same time. The data does not need to be held in memory at once.
+ * The new file has mode 0644.
+ *
+ * @return an error if the file cannot be written.
+ */
+template <typename Fn, typename = std::enable_if_t<!std::is_convertible<Fn, std::string>::value>>
+expected<void, ErrorType> writeFileAtomic(const std::string& filename, Fn&& fill) {
+    MB_TRACE_SCOPE("io::writeFileAtomic");
+    std::string tmpPath = filename + ".XXXXXX";
+    bool created = false;
+    const auto fail = [&] {
+        if (created) std::remove(tmpPath.c_str());
+        MB_TRACE_COUNTER("io::writeFileAtomic.errors", 1);
+        return make_unexpected(std::string("Failed to write file '") + filename + std::string("'"));
+    };
+
+#if MB_PLATFORM_IS_WIN32
+    if (::_mktemp_s(&tmpPath[0], tmpPath.size() + 1) != 0) return fail();
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wbx");
+    if (!file) return fail();
+    created = true;
+    FileWriter writer(file);
+    const bool written = fill(writer) && writer.flush() && std::fflush(file) == 0 && ::_commit(::_fileno(file)) == 0;
+    if (std::fclose(file) != 0 || !written) return fail();
+    // Unlike `std::rename()`, replaces an existing file.
+    if (!::MoveFileExA(tmpPath.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        return fail();
+    }
+#else
+    internal::FileDescriptor file(::mkstemp(&tmpPath[0]));
+    if (!file) return fail();
+    created = true;
+    if (::fcntl(file.get(), F_SETFD, FD_CLOEXEC) != 0 || ::fchmod(file.get(), 0644) != 0) return fail();
+    FileWriter writer(file.get());
+    if (!fill(writer) || !writer.flush() || ::fsync(file.get()) != 0 || !file.close()) return fail();
+    if (std::rename(tmpPath.c_str(), filename.c_str()) != 0) return fail();
+
+    // Makes the rename durable too.
+    const std::size_t slash = filename.rfind('/');
+    const std::string directory =
+        slash == std::string::npos ? std::string(".") : slash == 0 ? std::string("/") : filename.substr(0, slash);
+    const auto dir = internal::FileDescriptor::open(directory, O_RDONLY | O_DIRECTORY);
+    if (dir && ::fsync(dir.get()) != 0 && errno != EINVAL) {
+        MB_TRACE_COUNTER("io::writeFileAtomic.errors", 1);
+        return make_unexpected(std::string("Failed to write file '") + filename + std::string("'"));
+    }
+#endif
+
+    MB_TRACE_HISTOGRAM("io::writeFileAtomic.bytes", static_cast<double>(writer.offset()));
+    return expected<void, ErrorType>();
+}
+
+/**
+ * @brief Replaces \a filename with \a data, see the streaming overload.
+ */
+inline expected<void, ErrorType> writeFileAtomic(const std::string& filename, const std::string& data) {
+    return writeFileAtomic(filename, [&data](FileWriter& writer) { return writer.write(data.data(), data.size()); });
 }
 
 } // namespace io
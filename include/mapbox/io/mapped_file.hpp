@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "mapbox/io/io.hpp"
+#include "mapbox/platform.hpp"
+#include "mapbox/util/expected.hpp"
+#include "mapbox/util/trace.hpp"
+
+#if !MB_PLATFORM_IS_WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace mapbox {
+namespace base {
+namespace io {
+
+/**
+ * @brief Read-only view of a whole file mapped into memory.
+ *
+ * On POSIX platforms the file is mapped with `mmap()`, so its pages are
+ * shared with the page cache and only loaded when touched. Elsewhere the
+ * file contents are read into memory with \c readFile().
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0u)),
+          contents_(std::move(other.contents_)) {
+        if (!contents_.empty()) data_ = contents_.data();
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0u);
+            contents_ = std::move(other.contents_);
+            if (!contents_.empty()) data_ = contents_.data();
+        }
+        return *this;
+    }
+
+    ~MappedFile() { unmap(); }
+
+    /**
+     * @brief Maps \a filename into memory.
+     *
+     * @return the mapping, or an error if the file cannot be opened or mapped.
+     */
+    static expected<MappedFile, ErrorType> open(const std::string& filename) {
+        MB_TRACE_SCOPE("io::MappedFile::open");
+        MappedFile file;
+#if MB_PLATFORM_IS_WIN32
+        auto contents = readFile(filename);
+        if (!contents) {
+            return make_unexpected(std::string("Failed to map file '") + filename + std::string("'"));
+        }
+        file.contents_ = std::move(*contents);
+        file.data_ = file.contents_.data();
+        file.size_ = file.contents_.size();
+#else
+        const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return make_unexpected(std::string("Failed to map file '") + filename + std::string("'"));
+        }
+
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return make_unexpected(std::string("Failed to map file '") + filename + std::string("'"));
+        }
+
+        if (info.st_size > 0) {
+            void* addr = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                return make_unexpected(std::string("Failed to map file '") + filename + std::string("'"));
+            }
+            file.data_ = static_cast<const char*>(addr);
+            file.size_ = static_cast<std::size_t>(info.st_size);
+        }
+        ::close(fd);
+#endif
+        return expected<MappedFile, ErrorType>(std::move(file));
+    }
+
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0u; }
+
+private:
+    void unmap() noexcept {
+#if !MB_PLATFORM_IS_WIN32
+        if (data_ && contents_.empty()) {
+            ::munmap(const_cast<char*>(data_), size_); // NOLINT cppcoreguidelines-pro-type-const-cast
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0u;
+        contents_.clear();
+    }
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0u;
+    std::string contents_;
+};
+
+} // namespace io
+} // namespace base
+} // namespace mapbox
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <jni/jni.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mapbox/compatibility/value.hpp"
+#include "mapbox/compatibility/value_codec.hpp"
+#include "mapbox/util/expected.hpp"
+
+namespace mapbox {
+namespace base {
+
+/**
+ * @brief jni.hpp tag of \c java.nio.ByteBuffer.
+ */
+struct ByteBufferTag {
+    static constexpr auto Name() { return "java/nio/ByteBuffer"; }
+};
+
+/**
+ * @brief Version of the format Values are handed to and from Java code in:
+ * this byte followed by the \c encodeValue() encoding.
+ *
+ * `java/com/mapbox/base/ValueCodec.java` encodes and decodes the format on
+ * the Java side.
+ */
+constexpr uint8_t kValueFormatVersion = 1;
+
+/**
+ * @brief Memory of a direct \c java.nio.ByteBuffer.
+ */
+struct DirectBuffer {
+    char* data = nullptr;
+    std::size_t size = 0u;
+};
+
+/// @cond internal
+namespace internal {
+
+inline bool fitsByteBuffer(std::size_t size) {
+    return size <= static_cast<std::size_t>(std::numeric_limits<jni::jint>::max());
+}
+
+// Raises a Java exception and unwinds like the jni.hpp functions do.
+[[noreturn]] inline void throwJavaException(jni::JNIEnv& env, const char* type, const char* message) {
+    jni::ThrowNew(env, jni::FindClass(env, type), message);
+    throw jni::PendingJavaException();
+}
+
+inline void encodeValueForJava(const Value& value, std::string& out) {
+    out.push_back(static_cast<char>(kValueFormatVersion));
+    encodeValue(value, out);
+}
+
+inline expected<Value, std::string> decodeValueFromJava(const char* data, std::size_t size) {
+    if (size == 0u) {
+        return make_unexpected(std::string("Invalid encoded value"));
+    }
+    if (static_cast<uint8_t>(data[0]) != kValueFormatVersion) {
+        return make_unexpected(std::string("Unsupported encoded value version"));
+    }
+    return decodeValue(data + 1, size - 1);
+}
+
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Wraps \a data in a direct \c ByteBuffer without copying it.
+ *
+ * The memory is shared with Java code and must outlive the returned buffer,
+ * for example by being owned by the peer object handing it out.
+ *
+ * Like the jni.hpp functions, throws \c jni::PendingJavaException with a
+ * Java exception pending if the buffer cannot be created, an
+ * \c IllegalArgumentException if \a size does not fit a \c ByteBuffer.
+ */
+inline jni::Local<jni::Object<ByteBufferTag>> newDirectByteBuffer(jni::JNIEnv& env, char* data, std::size_t size) {
+    if (!internal::fitsByteBuffer(size)) {
+        internal::throwJavaException(env, "java/lang/IllegalArgumentException", "Buffer is too large for a ByteBuffer");
+    }
+    jobject buffer = env.NewDirectByteBuffer(data, static_cast<jlong>(size));
+    jni::CheckJavaException(env);
+    if (!buffer) {
+        internal::throwJavaException(
+            env, "java/lang/UnsupportedOperationException", "Direct buffers are not supported");
+    }
+    return jni::Local<jni::Object<ByteBufferTag>>(env, buffer);
+}
+
+/**
+ * @brief Wraps \a data in a read-only direct \c ByteBuffer without copying
+ * it, for memory that must not be written like an \c io::MappedFile.
+ *
+ * Costs a Java call on top of \c newDirectByteBuffer(), which is
+ * independent of \a size.
+ */
+inline jni::Local<jni::Object<ByteBufferTag>> newReadOnlyByteBuffer(jni::JNIEnv& env,
+                                                                    const char* data,
+                                                                    std::size_t size) {
+    static auto& type = jni::Class<ByteBufferTag>::Singleton(env);
+    static auto asReadOnlyBuffer = type.GetMethod<jni::Object<ByteBufferTag>()>(env, "asReadOnlyBuffer");
+
+    const auto buffer =
+        newDirectByteBuffer(env, const_cast<char*>(data), size); // NOLINT cppcoreguidelines-pro-type-const-cast
+    return buffer.Call(env, asReadOnlyBuffer);
+}
+
+/**
+ * @brief Wraps the contents of \a buffer, an \c io::MappedFile,
+ * \c io::BlobView or any type with `data()` and `size()`, in a read-only
+ * direct \c ByteBuffer without copying it.
+ */
+template <typename Buffer>
+jni::Local<jni::Object<ByteBufferTag>> newReadOnlyByteBuffer(jni::JNIEnv& env, const Buffer& buffer) {
+    return newReadOnlyByteBuffer(env, buffer.data(), buffer.size());
+}
+
+/**
+ * @brief Returns the memory of the direct \c ByteBuffer \a buffer, which
+ * can be read and written in place while the buffer is referenced.
+ *
+ * @return an error for heap buffers.
+ */
+inline expected<DirectBuffer, std::string> getDirectBuffer(jni::JNIEnv& env,
+                                                           const jni::Object<ByteBufferTag>& buffer) {
+    void* data = env.GetDirectBufferAddress(buffer.get());
+    const jlong capacity = env.GetDirectBufferCapacity(buffer.get());
+    if (capacity < 0 || (!data && capacity > 0)) {
+        return make_unexpected(std::string("ByteBuffer is not direct"));
+    }
+    DirectBuffer result;
+    result.data = static_cast<char*>(data);
+    result.size = static_cast<std::size_t>(capacity);
+    return expected<DirectBuffer, std::string>(result);
+}
+
+/**
+ * @brief Converts \a value to a Java `byte[]` in the format of
+ * \c kValueFormatVersion, which `ValueCodec.decode()` reads.
+ *
+ * Unlike building Java maps and lists element by element, this takes a
+ * fixed number of JNI calls whatever the size of \a value.
+ *
+ * Throws \c jni::PendingJavaException with a Java exception pending if the
+ * array cannot be allocated, an \c IllegalArgumentException if the
+ * encoding does not fit a `byte[]`.
+ */
+inline jni::Local<jni::Array<jni::jbyte>> valueToByteArray(jni::JNIEnv& env, const Value& value) {
+    std::string encoded;
+    internal::encodeValueForJava(value, encoded);
+    if (!internal::fitsByteBuffer(encoded.size())) {
+        internal::throwJavaException(env, "java/lang/IllegalArgumentException", "Value is too large for a byte array");
+    }
+
+    const std::vector<jni::jbyte> bytes(encoded.begin(), encoded.end());
+    auto array = jni::Array<jni::jbyte>::New(env, static_cast<jni::jsize>(bytes.size()));
+    array.SetRegion(env, 0, bytes);
+    return array;
+}
+
+/**
+ * @brief Encodes \a value into \a storage in the format of
+ * \c kValueFormatVersion and wraps it in a read-only direct \c ByteBuffer,
+ * so that `ValueCodec.decode()` reads it in place without a copy to the
+ * Java heap.
+ *
+ * \a storage must be kept alive and unmodified while the buffer is used.
+ */
+inline jni::Local<jni::Object<ByteBufferTag>> valueToByteBuffer(jni::JNIEnv& env,
+                                                                const Value& value,
+                                                                std::string& storage) {
+    storage.clear();
+    internal::encodeValueForJava(value, storage);
+    return newReadOnlyByteBuffer(env, storage);
+}
+
+/**
+ * @brief Decodes a value encoded by `ValueCodec.encode()` in a `byte[]`.
+ *
+ * The array is copied out with a single `GetByteArrayRegion()` before
+ * decoding, so that the garbage collector is not held up while the value
+ * is built. Use \c valueFromByteBuffer() to decode large values in place.
+ *
+ * @return an error if the array does not hold an encoded value or was
+ * encoded in another version of the format.
+ */
+inline expected<Value, std::string> valueFromByteArray(jni::JNIEnv& env, const jni::Array<jni::jbyte>& array) {
+    std::vector<jni::jbyte> bytes(array.Length(env));
+    array.GetRegion(env, 0, bytes);
+    return internal::decodeValueFromJava(reinterpret_cast<const char*>(bytes.data()), bytes.size()); // NOLINT
+}
+
+/**
+ * @brief Decodes a value encoded by `ValueCodec.encodeDirect()` in the
+ * direct \c ByteBuffer \a buffer, in place. The whole capacity of the buffer
+ * is read.
+ *
+ * @return an error for heap buffers, and if the buffer does not hold an
+ * encoded value or was encoded in another version of the format.
+ */
+inline expected<Value, std::string> valueFromByteBuffer(jni::JNIEnv& env, const jni::Object<ByteBufferTag>& buffer) {
+    const auto direct = getDirectBuffer(env, buffer);
+    if (!direct) {
+        return make_unexpected(std::string(direct.error()));
+    }
+    return internal::decodeValueFromJava(direct->data, direct->size);
+}
+
+} // namespace base
+} // namespace mapbox
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mapbox/io/io.hpp"
+#include "mapbox/io/mapped_file.hpp"
+#include "mapbox/util/expected.hpp"
+
+namespace mapbox {
+namespace base {
+
+/// @cond internal
+namespace internal {
+namespace kdbush {
+
+// Same KD sort and queries as kdbush.hpp, over flat arrays: `ids` holds the
+// point indices and `coords` the interleaved x/y coordinates, both in KD
+// order. The ranges are inclusive, like in kdbush.hpp.
+
+inline void swapItem(uint32_t* ids, double* coords, std::size_t i, std::size_t j) {
+    std::swap(ids[i], ids[j]);
+    std::swap(coords[2 * i], coords[2 * j]);
+    std::swap(coords[2 * i + 1], coords[2 * j + 1]);
+}
+
+inline void select(
+    uint32_t* ids, double* coords, std::size_t k, std::size_t left, std::size_t right, std::size_t axis) {
+    while (right > left) {
+        if (right - left > 600) {
+            const double n = static_cast<double>(right - left + 1);
+            const double m = static_cast<double>(k - left + 1);
+            const double z = std::log(n);
+            const double s = 0.5 * std::exp(2 * z / 3);
+            const double r = k - m * s / n + 0.5 * std::sqrt(z * s * (1 - s / n)) * (2 * m < n ? -1 : 1);
+            select(ids,
+                   coords,
+                   k,
+                   std::max(left, static_cast<std::size_t>(std::max(0.0, std::floor(r)))),
+                   std::min(right, static_cast<std::size_t>(std::max(0.0, std::floor(r + s)))),
+                   axis);
+        }
+
+        const double t = coords[2 * k + axis];
+        std::size_t i = left;
+        std::size_t j = right;
+
+        swapItem(ids, coords, left, k);
+        if (coords[2 * right + axis] > t) swapItem(ids, coords, left, right);
+
+        while (i < j) {
+            swapItem(ids, coords, i, j);
+            i++;
+            j--;
+            while (coords[2 * i + axis] < t) i++;
+            while (coords[2 * j + axis] > t) j--;
+        }
+
+        if (coords[2 * left + axis] == t) {
+            swapItem(ids, coords, left, j);
+        } else {
+            j++;
+            swapItem(ids, coords, j, right);
+        }
+
+        if (j <= k) left = j + 1;
+        if (k <= j) {
+            if (j == 0) break;
+            right = j - 1;
+        }
+    }
+}
+
+inline void sortKD(
+    uint32_t* ids, double* coords, std::size_t nodeSize, std::size_t left, std::size_t right, std::size_t axis) {
+    if (right - left <= nodeSize) return;
+    const std::size_t m = left + (right - left) / 2;
+    select(ids, coords, m, left, right, axis);
+    sortKD(ids, coords, nodeSize, left, m - 1, 1 - axis);
+    sortKD(ids, coords, nodeSize, m + 1, right, 1 - axis);
+}
+
+template <typename TVisitor>
+void range(const uint32_t* ids,
+           const double* coords,
+           std::size_t nodeSize,
+           double minX,
+           double minY,
+           double maxX,
+           double maxY,
+           const TVisitor& visitor,
+           std::size_t left,
+           std::size_t right,
+           std::size_t axis) {
+    if (right - left <= nodeSize) {
+        for (std::size_t i = left; i <= right; i++) {
+            const double x = coords[2 * i];
+            const double y = coords[2 * i + 1];
+            if (x >= minX && x <= maxX && y >= minY && y <= maxY) visitor(ids[i]);
+        }
+        return;
+    }
+
+    const std::size_t m = left + (right - left) / 2;
+    const double x = coords[2 * m];
+    const double y = coords[2 * m + 1];
+    if (x >= minX && x <= maxX && y >= minY && y <= maxY) visitor(ids[m]);
+
+    if (axis == 0 ? minX <= x : minY <= y) {
+        range(ids, coords, nodeSize, minX, minY, maxX, maxY, visitor, left, m - 1, 1 - axis);
+    }
+    if (axis == 0 ? maxX >= x : maxY >= y) {
+        range(ids, coords, nodeSize, minX, minY, maxX, maxY, visitor, m + 1, right, 1 - axis);
+    }
+}
+
+template <typename TVisitor>
+void within(const uint32_t* ids,
+            const double* coords,
+            std::size_t nodeSize,
+            double qx,
+            double qy,
+            double r,
+            const TVisitor& visitor,
+            std::size_t left,
+            std::size_t right,
+            std::size_t axis) {
+    const double r2 = r * r;
+
+    if (right - left <= nodeSize) {
+        for (std::size_t i = left; i <= right; i++) {
+            const double dx = coords[2 * i] - qx;
+            const double dy = coords[2 * i + 1] - qy;
+            if (dx * dx + dy * dy <= r2) visitor(ids[i]);
+        }
+        return;
+    }
+
+    const std::size_t m = left + (right - left) / 2;
+    const double x = coords[2 * m];
+    const double y = coords[2 * m + 1];
+    if ((x - qx) * (x - qx) + (y - qy) * (y - qy) <= r2) visitor(ids[m]);
+
+    if (axis == 0 ? qx - r <= x : qy - r <= y) {
+        within(ids, coords, nodeSize, qx, qy, r, visitor, left, m - 1, 1 - axis);
+    }
+    if (axis == 0 ? qx + r >= x : qy + r >= y) {
+        within(ids, coords, nodeSize, qx, qy, r, visitor, m + 1, right, 1 - axis);
+    }
+}
+
+} // namespace kdbush
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Read-only kdbush index memory-mapped from disk.
+ *
+ * The index is built once by \c write(), which KD-sorts the points exactly
+ * like kdbush.hpp does and stores the sorted ids and coordinates. \c open()
+ * maps the file, and \c range() and \c within() run directly over the
+ * mapped arrays, so opening an index has no build step and its pages are
+ * shared with the page cache.
+ *
+ * Point ids are the indices of the points passed to \c write().
+ */
+class StaticKDBush {
+public:
+    StaticKDBush() = default;
+
+    /**
+     * @brief Builds the index of the given points and writes it to \a path.
+     *
+     * The file is streamed through \c io::writeFileAtomic(), so readers see
+     * either the previous index or the new one.
+     *
+     * @param xs x coordinates of the points.
+     * @param ys y coordinates of the points.
+     * @param count number of points, less than 2^32.
+     * @param nodeSize number of points in the leaf nodes.
+     * @return an error if the file cannot be written.
+     */
+    static expected<void, io::ErrorType> write(
+        const std::string& path, const double* xs, const double* ys, std::size_t count, uint32_t nodeSize = 64) {
+        if (count > std::numeric_limits<uint32_t>::max() || nodeSize == 0) {
+            return make_unexpected(std::string("Failed to write file '") + path + std::string("'"));
+        }
+
+        std::vector<uint32_t> ids(count);
+        std::vector<double> coords(2 * count);
+        for (std::size_t i = 0; i < count; ++i) {
+            ids[i] = static_cast<uint32_t>(i);
+            coords[2 * i] = xs[i];
+            coords[2 * i + 1] = ys[i];
+        }
+        if (count > 0) {
+            internal::kdbush::sortKD(ids.data(), coords.data(), nodeSize, 0, count - 1, 0);
+        }
+
+        const Header header{kMagic, kVersion, count, nodeSize, 0};
+        const std::size_t idsEnd = sizeof(Header) + count * sizeof(uint32_t);
+        const char padding[alignof(double)] = {};
+        return io::writeFileAtomic(path, [&](io::FileWriter& writer) {
+            return writer.write(reinterpret_cast<const char*>(&header), sizeof(Header)) &&          // NOLINT
+                   writer.write(reinterpret_cast<const char*>(ids.data()), count * sizeof(uint32_t)) && // NOLINT
+                   writer.write(padding, coordsOffset(count) - idsEnd) &&
+                   writer.write(reinterpret_cast<const char*>(coords.data()), coords.size() * sizeof(double)); // NOLINT
+        });
+    }
+
+    /**
+     * @brief Builds the index of \a points, which have `x` and `y` members,
+     * and writes it to \a path.
+     */
+    template <typename TPoint>
+    static expected<void, io::ErrorType> write(const std::string& path,
+                                               const std::vector<TPoint>& points,
+                                               uint32_t nodeSize = 64) {
+        std::vector<double> xs;
+        std::vector<double> ys;
+        xs.reserve(points.size());
+        ys.reserve(points.size());
+        for (const auto& point : points) {
+            xs.push_back(static_cast<double>(point.x));
+            ys.push_back(static_cast<double>(point.y));
+        }
+        return write(path, xs.data(), ys.data(), points.size(), nodeSize);
+    }
+
+    /**
+     * @brief Maps the index written by \c write() at \a path.
+     *
+     * @return the index, or an error if the file cannot be mapped or is not
+     * a valid index.
+     */
+    static expected<StaticKDBush, io::ErrorType> open(const std::string& path) {
+        auto mapped = io::MappedFile::open(path);
+        if (!mapped) {
+            return nonstd::make_unexpected(mapped.error());
+        }
+
+        const auto invalid = [&path] {
+            return make_unexpected(std::string("Invalid kdbush index file '") + path + std::string("'"));
+        };
+
+        const char* data = mapped->data();
+        const std::size_t size = mapped->size();
+        Header header{};
+        if (size < sizeof(Header)) return invalid();
+        std::memcpy(&header, data, sizeof(Header));
+        if (header.magic != kMagic || header.version != kVersion || header.nodeSize == 0 ||
+            header.count > std::numeric_limits<uint32_t>::max() ||
+            size != coordsOffset(header.count) + 2 * header.count * sizeof(double) ||
+            reinterpret_cast<std::uintptr_t>(data) % alignof(double) != 0) { // NOLINT
+            return invalid();
+        }
+
+        StaticKDBush index;
+        index.ids_ = reinterpret_cast<const uint32_t*>(data + sizeof(Header));                 // NOLINT
+        index.coords_ = reinterpret_cast<const double*>(data + coordsOffset(header.count)); // NOLINT
+        index.size_ = static_cast<std::size_t>(header.count);
+        index.nodeSize_ = header.nodeSize;
+        index.file_ = std::move(*mapped);
+        return expected<StaticKDBush, io::ErrorType>(std::move(index));
+    }
+
+    /**
+     * @brief Calls \a visitor with the id of every point inside the box.
+     */
+    template <typename TVisitor>
+    void range(double minX, double minY, double maxX, double maxY, const TVisitor& visitor) const {
+        if (size_ == 0) return;
+        internal::kdbush::range(ids_, coords_, nodeSize_, minX, minY, maxX, maxY, visitor, 0, size_ - 1, 0);
+    }
+
+    /**
+     * @brief Calls \a visitor with the id of every point within \a radius
+     * of (\a qx, \a qy).
+     */
+    template <typename TVisitor>
+    void within(double qx, double qy, double radius, const TVisitor& visitor) const {
+        if (size_ == 0) return;
+        internal::kdbush::within(ids_, coords_, nodeSize_, qx, qy, radius, visitor, 0, size_ - 1, 0);
+    }
+
+    /**
+     * @brief Number of indexed points.
+     */
+    std::size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Number of points in the leaf nodes.
+     */
+    std::size_t nodeSize() const noexcept { return nodeSize_; }
+
+private:
+    static constexpr uint32_t kMagic = 0x444b424d; // "MBKD"
+    static constexpr uint32_t kVersion = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t count;
+        uint32_t nodeSize;
+        uint32_t reserved;
+    };
+
+    static std::size_t coordsOffset(uint64_t count) {
+        const std::size_t end = sizeof(Header) + static_cast<std::size_t>(count) * sizeof(uint32_t);
+        return (end + alignof(double) - 1) / alignof(double) * alignof(double);
+    }
+
+    io::MappedFile file_;
+    const uint32_t* ids_ = nullptr;
+    const double* coords_ = nullptr;
+    std::size_t size_ = 0u;
+    std::size_t nodeSize_ = 64u;
+};
+
+} // namespace base
+} // namespace mapbox
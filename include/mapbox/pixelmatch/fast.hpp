@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <mapbox/pixelmatch.hpp>
+
+#include "mapbox/platform.hpp"
+#include "mapbox/util/cpu.hpp"
+#include "mapbox/util/scheduler.hpp"
+
+#if MB_ARCH_IS_X86 && (MB_COMPILER == MB_COMPILER_GNU || MB_COMPILER == MB_COMPILER_CLANG)
+#    define MB_PIXELMATCH_X86 1
+#    include <immintrin.h>
+#endif
+
+namespace mapbox {
+namespace base {
+
+/**
+ * @brief SIMD kernel used to compute the per-pixel color deltas.
+ */
+enum class PixelmatchKernel { Auto, Scalar, SSE41, AVX2 };
+
+/**
+ * @brief Options for \c mapbox::base::pixelmatch().
+ */
+struct PixelmatchOptions {
+    /**
+     * Matching threshold, ranges from 0 to 1. Smaller values make the
+     * comparison more sensitive.
+     */
+    double threshold = 0.1;
+
+    /**
+     * Whether to count anti-aliased pixels as mismatches.
+     */
+    bool includeAA = false;
+
+    /**
+     * Stops the comparison as soon as more than \c maxMismatches pixels
+     * were found to differ.
+     */
+    uint64_t maxMismatches = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * Number of threads comparing row bands, `0` meaning
+     * `std::thread::hardware_concurrency()`.
+     */
+    std::size_t threads = 1;
+
+    /**
+     * If set, row bands are compared on this scheduler instead of
+     * dedicated threads, `threads == 0` then meaning all its workers.
+     */
+    Scheduler* scheduler = nullptr;
+
+    PixelmatchKernel kernel = PixelmatchKernel::Auto;
+};
+
+/// @cond internal
+namespace internal {
+namespace pixelmatch {
+
+// Only the color delta kernels live here. The scalar color delta, the
+// anti-aliasing detection and the diff image drawing are the pixelmatch-cpp
+// helpers, so that both implementations cannot drift apart.
+
+// Flags the pixels of a row whose color delta exceeds `maxDelta` and returns
+// how many were flagged.
+using ClassifyFn = std::size_t (*)(const uint8_t*, const uint8_t*, std::size_t, double, uint8_t*);
+
+namespace scalar {
+
+inline std::size_t classify(
+    const uint8_t* row1, const uint8_t* row2, std::size_t width, double maxDelta, uint8_t* flags) {
+    std::size_t count = 0;
+    for (std::size_t x = 0; x < width; ++x) {
+        const std::size_t pos = x * 4;
+        const bool different =
+            std::memcmp(row1 + pos, row2 + pos, 4) != 0 && mapbox::colorDelta(row1, row2, pos, pos) > maxDelta;
+        flags[x] = static_cast<uint8_t>(different);
+        count += static_cast<std::size_t>(different);
+    }
+    return count;
+}
+
+} // namespace scalar
+
+#if MB_PIXELMATCH_X86
+namespace sse41 {
+
+// `255 + (c - 255) * a` truncated, for the channel in the low byte of each of
+// the two low 32-bit lanes.
+__attribute__((target("sse4.1"))) inline __m128d blend(__m128i bits, __m128d a) {
+    const __m128d c = _mm_cvtepi32_pd(_mm_and_si128(bits, _mm_set1_epi32(0xff)));
+    const __m128d blended = _mm_add_pd(_mm_set1_pd(255), _mm_mul_pd(_mm_sub_pd(c, _mm_set1_pd(255)), a));
+    return _mm_round_pd(blended, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+
+// Blended Y, I and Q of two RGBA pixels held in the low 64 bits of `pixels`,
+// with the same operation order as the pixelmatch-cpp helpers.
+__attribute__((target("sse4.1"))) inline void yiq(__m128i pixels, __m128d& y, __m128d& i, __m128d& q) {
+    const __m128d a = _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_epi32(pixels, 24)), _mm_set1_pd(255));
+    const __m128d r = blend(pixels, a);
+    const __m128d g = blend(_mm_srli_epi32(pixels, 8), a);
+    const __m128d b = blend(_mm_srli_epi32(pixels, 16), a);
+
+    y = _mm_add_pd(_mm_add_pd(_mm_mul_pd(r, _mm_set1_pd(0.29889531)), _mm_mul_pd(g, _mm_set1_pd(0.58662247))),
+                   _mm_mul_pd(b, _mm_set1_pd(0.11448223)));
+    i = _mm_sub_pd(_mm_sub_pd(_mm_mul_pd(r, _mm_set1_pd(0.59597799)), _mm_mul_pd(g, _mm_set1_pd(0.27417610))),
+                   _mm_mul_pd(b, _mm_set1_pd(0.32180189)));
+    q = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(r, _mm_set1_pd(0.21147017)), _mm_mul_pd(g, _mm_set1_pd(0.52261711))),
+                   _mm_mul_pd(b, _mm_set1_pd(0.31114694)));
+}
+
+__attribute__((target("sse4.1"))) inline int exceeds(__m128i pixels1, __m128i pixels2, __m128d maxDelta) {
+    __m128d y1, i1, q1, y2, i2, q2;
+    yiq(pixels1, y1, i1, q1);
+    yiq(pixels2, y2, i2, q2);
+    const __m128d y = _mm_sub_pd(y1, y2);
+    const __m128d i = _mm_sub_pd(i1, i2);
+    const __m128d q = _mm_sub_pd(q1, q2);
+    const __m128d delta = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_mul_pd(_mm_set1_pd(0.5053), y), y),
+                                                _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(0.299), i), i)),
+                                     _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(0.1957), q), q));
+    return _mm_movemask_pd(_mm_cmpgt_pd(delta, maxDelta));
+}
+
+__attribute__((target("sse4.1"))) inline std::size_t classify(
+    const uint8_t* row1, const uint8_t* row2, std::size_t width, double maxDelta, uint8_t* flags) {
+    const __m128d vmaxDelta = _mm_set1_pd(maxDelta);
+    std::size_t count = 0;
+    std::size_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 4)); // NOLINT
+        const __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row2 + x * 4)); // NOLINT
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(p1, p2)) == 0xffff) {
+            std::memset(flags + x, 0, 4);
+            continue;
+        }
+        const int bits = exceeds(p1, p2, vmaxDelta) | (exceeds(_mm_srli_si128(p1, 8), _mm_srli_si128(p2, 8), vmaxDelta) << 2);
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            flags[x + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+        }
+        count += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(bits)));
+    }
+    return count + scalar::classify(row1 + x * 4, row2 + x * 4, width - x, maxDelta, flags + x);
+}
+
+inline bool supported() {
+    return cpuSupports(CPUFeature::SSE41);
+}
+
+} // namespace sse41
+
+namespace avx2 {
+
+__attribute__((target("avx2"))) inline __m256d blend(__m128i bits, __m256d a) {
+    const __m256d c = _mm256_cvtepi32_pd(_mm_and_si128(bits, _mm_set1_epi32(0xff)));
+    const __m256d blended = _mm256_add_pd(_mm256_set1_pd(255), _mm256_mul_pd(_mm256_sub_pd(c, _mm256_set1_pd(255)), a));
+    return _mm256_round_pd(blended, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+
+// Blended Y, I and Q of four RGBA pixels.
+__attribute__((target("avx2"))) inline void yiq(__m128i pixels, __m256d& y, __m256d& i, __m256d& q) {
+    const __m256d a = _mm256_div_pd(_mm256_cvtepi32_pd(_mm_srli_epi32(pixels, 24)), _mm256_set1_pd(255));
+    const __m256d r = blend(pixels, a);
+    const __m256d g = blend(_mm_srli_epi32(pixels, 8), a);
+    const __m256d b = blend(_mm_srli_epi32(pixels, 16), a);
+
+    y = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(r, _mm256_set1_pd(0.29889531)), _mm256_mul_pd(g, _mm256_set1_pd(0.58662247))),
+        _mm256_mul_pd(b, _mm256_set1_pd(0.11448223)));
+    i = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_mul_pd(r, _mm256_set1_pd(0.59597799)), _mm256_mul_pd(g, _mm256_set1_pd(0.27417610))),
+        _mm256_mul_pd(b, _mm256_set1_pd(0.32180189)));
+    q = _mm256_add_pd(
+        _mm256_sub_pd(_mm256_mul_pd(r, _mm256_set1_pd(0.21147017)), _mm256_mul_pd(g, _mm256_set1_pd(0.52261711))),
+        _mm256_mul_pd(b, _mm256_set1_pd(0.31114694)));
+}
+
+__attribute__((target("avx2"))) inline int exceeds(__m128i pixels1, __m128i pixels2, __m256d maxDelta) {
+    __m256d y1, i1, q1, y2, i2, q2;
+    yiq(pixels1, y1, i1, q1);
+    yiq(pixels2, y2, i2, q2);
+    const __m256d y = _mm256_sub_pd(y1, y2);
+    const __m256d i = _mm256_sub_pd(i1, i2);
+    const __m256d q = _mm256_sub_pd(q1, q2);
+    const __m256d delta =
+        _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.5053), y), y),
+                                    _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.299), i), i)),
+                      _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.1957), q), q));
+    return _mm256_movemask_pd(_mm256_cmp_pd(delta, maxDelta, _CMP_GT_OQ));
+}
+
+__attribute__((target("avx2"))) inline std::size_t classify(
+    const uint8_t* row1, const uint8_t* row2, std::size_t width, double maxDelta, uint8_t* flags) {
+    const __m256d vmaxDelta = _mm256_set1_pd(maxDelta);
+    std::size_t count = 0;
+    std::size_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + x * 4)); // NOLINT
+        const __m256i p2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row2 + x * 4)); // NOLINT
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(p1, p2)) == -1) {
+            std::memset(flags + x, 0, 8);
+            continue;
+        }
+        const int bits = exceeds(_mm256_castsi256_si128(p1), _mm256_castsi256_si128(p2), vmaxDelta) |
+                         (exceeds(_mm256_extracti128_si256(p1, 1), _mm256_extracti128_si256(p2, 1), vmaxDelta) << 4);
+        for (std::size_t lane = 0; lane < 8; ++lane) {
+            flags[x + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+        }
+        count += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(bits)));
+    }
+    return count + scalar::classify(row1 + x * 4, row2 + x * 4, width - x, maxDelta, flags + x);
+}
+
+inline bool supported() {
+    return cpuSupports(CPUFeature::AVX2);
+}
+
+} // namespace avx2
+#endif
+
+inline bool supported(PixelmatchKernel kernel) {
+    switch (kernel) {
+        case PixelmatchKernel::Auto:
+        case PixelmatchKernel::Scalar:
+            return true;
+#if MB_PIXELMATCH_X86
+        case PixelmatchKernel::SSE41:
+            return sse41::supported();
+        case PixelmatchKernel::AVX2:
+            return avx2::supported();
+#endif
+        default:
+            return false;
+    }
+}
+
+inline ClassifyFn classifier(PixelmatchKernel kernel) {
+    switch (kernel) {
+        case PixelmatchKernel::Auto: {
+#if MB_PIXELMATCH_X86
+            static const ClassifyFn best = CPUDispatch<ClassifyFn>(scalar::classify)
+                                               .add(CPUFeature::SSE41, sse41::classify)
+                                               .add(CPUFeature::AVX2, avx2::classify)
+                                               .select();
+            return best;
+#else
+            break;
+#endif
+        }
+#if MB_PIXELMATCH_X86
+        case PixelmatchKernel::SSE41:
+            if (sse41::supported()) return sse41::classify;
+            break;
+        case PixelmatchKernel::AVX2:
+            if (avx2::supported()) return avx2::classify;
+            break;
+#endif
+        default:
+            break;
+    }
+    return scalar::classify;
+}
+
+} // namespace pixelmatch
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Returns whether \a kernel can run on this CPU.
+ */
+inline bool pixelmatchKernelSupported(PixelmatchKernel kernel) {
+    return internal::pixelmatch::supported(kernel);
+}
+
+/**
+ * @brief Compares two RGBA images, with the same metric as pixelmatch-cpp.
+ *
+ * Identical pixels are skipped in bulk and the YIQ deltas of the other ones
+ * are computed several pixels at a time with the SSE4.1 or AVX2 kernel, in
+ * double precision and with the same operation order as pixelmatch-cpp,
+ * so the results do not depend on the kernel. Rows are split in bands
+ * across \c PixelmatchOptions::threads threads.
+ *
+ * @param img1 first image, `width * height * 4` bytes.
+ * @param img2 second image, `width * height * 4` bytes.
+ * @param output if not null, receives the diff image, `width * height * 4` bytes.
+ * @return the number of mismatched pixels. If it exceeds
+ * \c PixelmatchOptions::maxMismatches, the comparison stopped early, the
+ * returned count is a lower bound and \a output is only partially written.
+ */
+inline uint64_t pixelmatch(const uint8_t* img1,
+                           const uint8_t* img2,
+                           std::size_t width,
+                           std::size_t height,
+                           uint8_t* output,
+                           const PixelmatchOptions& options) {
+    namespace detail = internal::pixelmatch;
+
+    if (width == 0 || height == 0) return 0;
+
+    // Maximum acceptable square distance between two colors; 35215 is the
+    // maximum possible value for the YIQ difference metric.
+    const double maxDelta = 35215 * options.threshold * options.threshold;
+    const detail::ClassifyFn classify = detail::classifier(options.kernel);
+    const std::size_t rowBytes = width * 4;
+
+    constexpr std::size_t kBandRows = 16;
+    const std::size_t bands = (height + kBandRows - 1) / kBandRows;
+    std::atomic_size_t nextBand{0};
+    std::atomic<uint64_t> total{0};
+
+    const auto worker = [&] {
+        std::vector<uint8_t> flags(width);
+        for (std::size_t band = nextBand++; band < bands; band = nextBand++) {
+            const std::size_t end = std::min(height, (band + 1) * kBandRows);
+            for (std::size_t y = band * kBandRows; y < end; ++y) {
+                if (total.load(std::memory_order_relaxed) > options.maxMismatches) return;
+
+                const std::size_t count = classify(img1 + y * rowBytes, img2 + y * rowBytes, width, maxDelta, flags.data());
+                if (!output && (count == 0 || options.includeAA)) {
+                    total += count;
+                    continue;
+                }
+
+                uint64_t diff = 0;
+                for (std::size_t x = 0; x < width; ++x) {
+                    const std::size_t pos = y * rowBytes + x * 4;
+                    if (flags[x]) {
+                        if (!options.includeAA && (mapbox::antialiased(img1, x, y, width, height, img2) ||
+                                                   mapbox::antialiased(img2, x, y, width, height, img1))) {
+                            // One of the pixels is anti-aliasing; draw as yellow and do not count as difference.
+                            if (output) mapbox::drawPixel(output, pos, 255, 255, 0);
+                        } else {
+                            // Found substantial difference not caused by anti-aliasing; draw it as red.
+                            if (output) mapbox::drawPixel(output, pos, 255, 0, 0);
+                            ++diff;
+                        }
+                    } else if (output) {
+                        // Pixels are similar; draw background as grayscale image blended with white.
+                        const uint8_t val = mapbox::blend(static_cast<uint8_t>(mapbox::grayPixel(img1, pos)), 0.1);
+                        mapbox::drawPixel(output, pos, val, val, val);
+                    }
+                }
+                total += diff;
+            }
+        }
+    };
+
+    std::size_t threads = options.threads;
+    if (threads == 0) {
+        threads = options.scheduler ? options.scheduler->threadCount() + 1
+                                    : std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, bands);
+
+    if (options.scheduler) {
+        parallelFor(*options.scheduler, 0, threads, [&worker](std::size_t) { worker(); });
+        return total;
+    }
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    return total;
+}
+
+} // namespace base
+} // namespace mapbox
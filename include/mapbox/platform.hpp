@@ -1,7 +1,6 @@
 #pragma once
 
 // Determine compiler
-#define MB_COMPILER 0
 #define MB_COMPILER_GNU 1
 #define MB_COMPILER_CLANG 2
 #define MB_COMPILER_MSVC 3
@@ -17,7 +16,6 @@
 #endif
 
 // Determine platform
-#define MB_PLATFORM 0
 #define MB_PLATFORM_WIN32 1
 #define MB_PLATFORM_LINUX 2
 #define MB_PLATFORM_MAC 3
@@ -63,6 +61,38 @@
 
 #define MB_PLATFORM_IS_DESKTOP (MB_PLATFORM_IS_LINUX || MB_PLATFORM_IS_MAC || MB_PLATFORM_IS_WIN32)
 
+// Determine architecture
+#define MB_ARCH_UNKNOWN 0
+#define MB_ARCH_X86 1
+#define MB_ARCH_X86_64 2
+#define MB_ARCH_ARM 3
+#define MB_ARCH_ARM64 4
+
+#if defined(__x86_64__) || defined(_M_X64)
+#    define MB_ARCH MB_ARCH_X86_64
+#elif defined(__i386__) || defined(_M_IX86)
+#    define MB_ARCH MB_ARCH_X86
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define MB_ARCH MB_ARCH_ARM64
+#elif defined(__arm__) || defined(_M_ARM)
+#    define MB_ARCH MB_ARCH_ARM
+#else
+#    define MB_ARCH MB_ARCH_UNKNOWN
+#endif
+
+#define MB_ARCH_IS_X86 (MB_ARCH == MB_ARCH_X86 || MB_ARCH == MB_ARCH_X86_64)
+#define MB_ARCH_IS_ARM (MB_ARCH == MB_ARCH_ARM || MB_ARCH == MB_ARCH_ARM64)
+
+// Size of a cache line, for padding data written by different threads
+// (Apple Silicon has 128 bytes cache lines). Can be overridden by the build.
+#ifndef MB_CACHE_LINE_SIZE
+#    if MB_ARCH == MB_ARCH_ARM64 && (MB_PLATFORM_IS_MAC || MB_PLATFORM_IS_IOS)
+#        define MB_CACHE_LINE_SIZE 128
+#    else
+#        define MB_CACHE_LINE_SIZE 64
+#    endif
+#endif
+
 #ifdef NDEBUG
 #    define MB_IS_DEBUG 0
 #else
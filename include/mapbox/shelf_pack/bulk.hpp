@@ -0,0 +1,174 @@
+#pragma once
+
+#include <mapbox/shelf-pack.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "mapbox/util/expected.hpp"
+
+namespace mapbox {
+namespace base {
+
+/**
+ * @brief A bin to be packed by \c packBulk().
+ */
+struct PackRequest {
+    int32_t id;
+    int32_t w;
+    int32_t h;
+};
+
+/**
+ * @brief A bin that changed its position after \c repack().
+ *
+ * Callers holding the atlas image copy the `w` x `h` region at
+ * (`fromX`, `fromY`) of the old image to (`toX`, `toY`) of the new one.
+ */
+struct BinMove {
+    int32_t id;
+    int32_t fromX;
+    int32_t fromY;
+    int32_t toX;
+    int32_t toY;
+    int32_t w;
+    int32_t h;
+};
+
+/**
+ * @brief Occupancy metrics of a packed atlas.
+ */
+struct PackStats {
+    /// Total area of the packed bins.
+    int64_t binArea = 0;
+    /// Area of the atlas.
+    int64_t atlasArea = 0;
+    /// Height of the atlas actually used by the bins.
+    int32_t usedHeight = 0;
+    /// `binArea / atlasArea`.
+    double occupancy = 0.0;
+    /// Fraction of the used part of the atlas (`width * usedHeight`) not
+    /// covered by any bin. Lower is better.
+    double fragmentation = 0.0;
+};
+
+/**
+ * @brief Packs all the \a requests in one pass.
+ *
+ * Requests are packed by decreasing height (then width), which keeps the
+ * shelves tight and avoids the fragmentation caused by packing in
+ * arbitrary order.
+ *
+ * @return the packed bins in the order of \a requests, `nullptr` for the
+ * ones that did not fit.
+ */
+inline std::vector<Bin*> packBulk(ShelfPack& pack, const std::vector<PackRequest>& requests) {
+    std::vector<std::size_t> order(requests.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return requests[a].h != requests[b].h ? requests[a].h > requests[b].h : requests[a].w > requests[b].w;
+    });
+
+    std::vector<Bin*> bins(requests.size(), nullptr);
+    for (const std::size_t i : order) {
+        bins[i] = pack.packOne(requests[i].id, requests[i].w, requests[i].h);
+    }
+    return bins;
+}
+
+/**
+ * @brief Computes the occupancy metrics of \a pack holding \a bins.
+ *
+ * \c ShelfPack does not expose its bins, so they are passed explicitly;
+ * null entries are ignored.
+ */
+inline PackStats packStats(const ShelfPack& pack, const std::vector<Bin*>& bins) {
+    PackStats stats;
+    stats.atlasArea = int64_t{pack.width()} * pack.height();
+    for (const Bin* bin : bins) {
+        if (!bin) continue;
+        stats.binArea += int64_t{bin->w} * bin->h;
+        stats.usedHeight = std::max(stats.usedHeight, bin->y + bin->h);
+    }
+
+    if (stats.atlasArea > 0) {
+        stats.occupancy = static_cast<double>(stats.binArea) / stats.atlasArea;
+    }
+    const int64_t usedArea = int64_t{pack.width()} * stats.usedHeight;
+    if (usedArea > 0) {
+        stats.fragmentation = 1.0 - static_cast<double>(stats.binArea) / usedArea;
+    }
+    return stats;
+}
+
+/**
+ * @brief Defragments \a pack by packing its bins again with \c packBulk().
+ *
+ * \c ShelfPack cannot list its bins, so \a ids must list all of them; a
+ * bin left out cannot be detected and is not in the repacked atlas. Ids of
+ * bins that are not in \a pack, and ids listed twice, are rejected.
+ *
+ * Bins keep their id and reference count, but are new objects: every
+ * `Bin*` obtained from \a pack before the call is invalidated, and has to
+ * be looked up again with `getBin()`. On error, \a pack is left untouched.
+ *
+ * @param options options \a pack was created with.
+ * @return the bins that moved, or an error if \a ids are invalid or the
+ * bins do not fit.
+ */
+inline expected<std::vector<BinMove>, std::string> repack(
+    ShelfPack& pack,
+    const std::vector<int32_t>& ids,
+    const ShelfPack::ShelfPackOptions& options = ShelfPack::ShelfPackOptions{}) {
+    struct Placement {
+        int32_t x;
+        int32_t y;
+        int32_t refcount;
+    };
+
+    std::vector<int32_t> sorted(ids);
+    std::sort(sorted.begin(), sorted.end());
+    const auto repeated = std::adjacent_find(sorted.begin(), sorted.end());
+    if (repeated != sorted.end()) {
+        return make_unexpected(std::string("Bin ") + std::to_string(*repeated) + " is listed twice");
+    }
+
+    std::vector<PackRequest> requests;
+    std::vector<Placement> placements;
+    requests.reserve(ids.size());
+    placements.reserve(ids.size());
+    for (const int32_t id : ids) {
+        const Bin* bin = pack.getBin(id);
+        if (!bin) {
+            return make_unexpected(std::string("Bin ") + std::to_string(id) + " is not in the atlas");
+        }
+        requests.push_back({bin->id, bin->w, bin->h});
+        placements.push_back({bin->x, bin->y, bin->refcount()});
+    }
+
+    ShelfPack repacked(pack.width(), pack.height(), options);
+    const std::vector<Bin*> bins = packBulk(repacked, requests);
+
+    std::vector<BinMove> moves;
+    for (std::size_t i = 0; i < bins.size(); ++i) {
+        Bin* bin = bins[i];
+        if (!bin) {
+            return make_unexpected(std::string("Bins do not fit in the repacked atlas"));
+        }
+        for (int32_t ref = 1; ref < placements[i].refcount; ++ref) {
+            repacked.ref(*bin);
+        }
+        if (bin->x != placements[i].x || bin->y != placements[i].y) {
+            moves.push_back({bin->id, placements[i].x, placements[i].y, bin->x, bin->y, bin->w, bin->h});
+        }
+    }
+
+    pack = std::move(repacked);
+    return expected<std::vector<BinMove>, std::string>(std::move(moves));
+}
+
+} // namespace base
+} // namespace mapbox
@@ -3,62 +3,139 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <shared_mutex>
 #include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+
+#include "mapbox/platform.hpp"
+#include "mapbox/util/trace.hpp"
 
 namespace mapbox {
 namespace base {
 
+/**
+ * Number of lock counters of a weak pointer. With more than one counter,
+ * each thread locks its own counter (a "big-reader" lock), so that readers
+ * on different cores do not contend on the same cache line; invalidation
+ * then has to drain every counter.
+ */
+#ifndef MB_WEAK_PTR_LOCK_SHARDS
+#    define MB_WEAK_PTR_LOCK_SHARDS 1
+#endif
+
+/**
+ * Whether the lock counters get a cache line of their own, away from the
+ * reference counts of the \c std::shared_ptr control block they are
+ * allocated with. Implied by sharded counters.
+ */
+#ifndef MB_WEAK_PTR_PADDED
+#    define MB_WEAK_PTR_PADDED (MB_WEAK_PTR_LOCK_SHARDS > 1)
+#endif
+
 /// @cond internal
 namespace internal {
 
-class WeakPtrSharedData {
+template <std::size_t Size>
+struct WeakPtrPadding {
+    char padding[Size];
+};
+
+template <>
+struct WeakPtrPadding<0> {};
+
+template <std::size_t Padding>
+struct WeakPtrLockCounter : WeakPtrPadding<Padding> {
+    std::atomic_size_t locks{0u};
+};
+
+// Padding is used rather than `alignas()`, as `std::make_shared()` does not
+// support over-aligned types before C++17.
+template <std::size_t Shards, bool Padded>
+class BasicWeakPtrSharedData : WeakPtrPadding<Padded ? MB_CACHE_LINE_SIZE : 0> {
 public:
-    WeakPtrSharedData() = default;
+    static_assert(Shards > 0, "At least one lock counter is needed");
 
-    void sharedLock() {
-        std::size_t noLocks = sharedLocks_;
-        std::size_t incremented;
+    BasicWeakPtrSharedData() = default;
+
+    /**
+     * @brief Returns the lock counter used by the calling thread.
+     */
+    static std::size_t currentShard() { return Shards == 1 ? 0u : threadSlot() % Shards; }
+
+    /**
+     * @brief Locks the given counter.
+     *
+     * @return false if the data is being invalidated or is invalid, in which
+     * case it was not locked.
+     */
+    bool sharedLock(std::size_t shard) {
+        std::atomic_size_t& sharedLocks = counters_[shard].locks;
+        std::size_t noLocks = sharedLocks;
         do {
-            if (noLocks == kInvalidValue) return;
-            incremented = noLocks + 1;
+            if ((noLocks & kInvalidBit) != 0u) return false;
             // `compare_exchange_weak()` is invoked in a cycle to handle the case,
-            // if another thread has just modified `sharedLocks_` (so that it is not
-            // equal to `noLocks` any more). We early return, if `sharedLocks_` became
-            // equal to `kInvalidValue`.
-        } while (!sharedLocks_.compare_exchange_weak(noLocks, incremented));
+            // if another thread has just modified `sharedLocks` (so that it is not
+            // equal to `noLocks` any more). We early return, if `sharedLocks` got
+            // marked as invalid.
+        } while (!contended(sharedLocks.compare_exchange_weak(noLocks, noLocks + 1)));
+        return true;
     }
 
-    void sharedUnlock() {
-        std::size_t noLocks = sharedLocks_;
-        std::size_t decremented;
-        do {
-            if (noLocks == kInvalidValue) return;
-            assert(noLocks > 0u);
-            decremented = noLocks - 1;
-        } while (!sharedLocks_.compare_exchange_weak(noLocks, decremented));
+    void sharedUnlock(std::size_t shard) {
+        const std::size_t noLocks = counters_[shard].locks--;
+        assert((noLocks & ~kInvalidBit) > 0u);
+        (void)noLocks;
     }
 
     void invalidate() {
+        MB_TRACE_SCOPE("WeakPtrFactory::invalidate");
         assert(valid());
-        std::size_t noLocks = 0u;
-        while (!sharedLocks_.compare_exchange_weak(noLocks, kInvalidValue)) {
-            assert(noLocks != kInvalidValue);
-            noLocks = 0u;
+        // Marking the counters first makes new locks fail, so that busy readers
+        // cannot starve the invalidation; then the locks still held are drained.
+        for (auto& counter : counters_) {
+            counter.locks.fetch_or(kInvalidBit);
         }
+        for (auto& counter : counters_) {
+            while (counter.locks != kInvalidBit) {
+                std::this_thread::yield();
+            }
+        }
+        counters_[0].locks = kInvalidValue;
         assert(!valid());
     }
 
-    bool valid() const { return sharedLocks_ != kInvalidValue; }
+    bool valid() const { return counters_[0].locks != kInvalidValue; }
 
 private:
-    static constexpr size_t kInvalidValue = std::numeric_limits<std::size_t>::max();
-    std::atomic_size_t sharedLocks_{0u};
+    // Set while invalidating, to refuse new locks.
+    static constexpr std::size_t kInvalidBit = ~(std::numeric_limits<std::size_t>::max() >> 1);
+    static constexpr std::size_t kInvalidValue = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t kCounterPadding =
+        Padded ? MB_CACHE_LINE_SIZE - sizeof(std::atomic_size_t) % MB_CACHE_LINE_SIZE : 0;
+
+    // Counts the failed compare-and-swaps of the lock counters.
+    static bool contended(bool exchanged) {
+        if (!exchanged) MB_TRACE_COUNTER("WeakPtr::lock.contended", 1);
+        return exchanged;
+    }
+
+    static std::size_t threadSlot() {
+        static std::atomic_size_t nextSlot{0u};
+        thread_local const std::size_t slot = nextSlot++;
+        return slot;
+    }
+
+    WeakPtrLockCounter<kCounterPadding> counters_[Shards];
 };
 
+using WeakPtrSharedData = BasicWeakPtrSharedData<MB_WEAK_PTR_LOCK_SHARDS, MB_WEAK_PTR_PADDED != 0>;
+
 using StrongRef = std::shared_ptr<WeakPtrSharedData>;
 using WeakRef = std::weak_ptr<WeakPtrSharedData>;
 
@@ -82,15 +159,18 @@ public:
     WeakPtrGuard(WeakPtrGuard&&) noexcept = default;
     ~WeakPtrGuard() {
         if (strong_) {
-            strong_->sharedUnlock();
+            strong_->sharedUnlock(shard_);
         }
     }
 
 private:
-    explicit WeakPtrGuard(internal::StrongRef strong) : strong_(std::move(strong)) {
+    explicit WeakPtrGuard(internal::StrongRef strong, std::size_t shard = 0u)
+        : strong_(std::move(strong)), shard_(shard) {
         assert(!strong_ || strong_->valid());
     }
     internal::StrongRef strong_;
+    // The guard may be released on another thread than the locking one.
+    std::size_t shard_;
 
     template <typename T>
     friend class internal::WeakPtrBase;
@@ -128,12 +208,15 @@ public:
      */
     WeakPtrGuard lock() const {
         if (StrongRef strong = weak_.lock()) {
-            strong->sharedLock();
-            if (strong->valid()) {
-                return WeakPtrGuard(std::move(strong));
+            const std::size_t shard = WeakPtrSharedData::currentShard();
+            if (strong->sharedLock(shard)) {
+                if (strong->valid()) {
+                    return WeakPtrGuard(std::move(strong), shard);
+                }
+                strong->sharedUnlock(shard);
             }
-            strong->sharedUnlock();
         }
+        MB_TRACE_COUNTER("WeakPtr::lock.failed", 1);
         return WeakPtrGuard(nullptr);
     }
 
@@ -360,6 +443,33 @@ public:
         };
     }
 
+    /**
+     * @brief Makes a weak wrapper for calling a method on the wrapped
+     * \c T instance with \a args bound as its first arguments.
+     *
+     * The bound arguments are moved into the wrapper and passed to \a method
+     * as lvalues, followed by the arguments given to the wrapper. Otherwise
+     * behaves like \c makeWeakMethod(Method).
+     *
+     * \code
+     *  std::function<void(int)> callback = weakFactory.makeWeakMethod(&T::onResponse, std::move(request));
+     * \endcode
+     *
+     * @param method Pointer to an \c T class method.
+     * @param args Arguments to bind.
+     * @return auto Callable object
+     */
+    template <typename Method, typename... Args>
+    auto makeWeakMethod(Method method, Args&&... args) {
+        return [weakPtr = makeWeakPtr(), method, bound = std::make_tuple(std::forward<Args>(args)...)](
+                   auto&&... params) mutable {
+            WeakPtrGuard guard = weakPtr.lock();
+            if (T* obj = weakPtr.get()) {
+                callBound(obj, method, bound, std::index_sequence_for<Args...>(), std::forward<decltype(params)>(params)...);
+            }
+        };
+    }
+
     /**
      * @brief Invalidates all existing weak pointers.
      *
@@ -376,6 +486,11 @@ public:
     }
 
 private:
+    template <typename Method, typename Bound, std::size_t... Indices, typename... Params>
+    static void callBound(T* obj, Method method, Bound& bound, std::index_sequence<Indices...>, Params&&... params) {
+        (obj->*method)(std::get<Indices>(bound)..., std::forward<Params>(params)...);
+    }
+
     internal::StrongRef strong_;
     T* obj_;
 };
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mapbox/io/io.hpp"
+#include "mapbox/util/expected.hpp"
+#include "mapbox/util/trace.hpp"
+
+namespace mapbox {
+namespace base {
+namespace trace {
+
+/**
+ * @brief Sink writing the events in the Chrome trace event format.
+ *
+ * The resulting file can be opened with Perfetto or `chrome://tracing`.
+ * Durations become complete events, counters report their running total
+ * and histogram samples are reported as counter values.
+ *
+ * Events are kept in memory until \c flush() is called.
+ */
+class ChromeTraceWriter final : public Sink {
+public:
+    explicit ChromeTraceWriter(std::string path) : path_(std::move(path)), origin_(Clock::now()) {}
+
+    void duration(const char* name, Clock::time_point start, Clock::time_point end) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back({'X', name, start - origin_, end - start, 0.0, threadIndex()});
+    }
+
+    void counter(const char* name, int64_t delta) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const int64_t total = counters_[name] += delta;
+        events_.push_back(
+            {'C', name, Clock::now() - origin_, Clock::duration::zero(), static_cast<double>(total), threadIndex()});
+    }
+
+    void histogram(const char* name, double value) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back({'C', name, Clock::now() - origin_, Clock::duration::zero(), value, threadIndex()});
+    }
+
+    /**
+     * @brief Number of events recorded so far.
+     */
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_.size();
+    }
+
+    /**
+     * @brief Writes all the events recorded so far to the trace file.
+     */
+    expected<void, io::ErrorType> flush() const {
+        std::vector<Event> events;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            events = events_;
+        }
+
+        std::string out("{\"traceEvents\":[");
+        char number[64];
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const Event& event = events[i];
+            if (i != 0) out += ',';
+            out += "\n{\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"ph\":\"";
+            out += event.phase;
+            std::snprintf(number, sizeof(number), "\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", event.thread, micros(event.ts));
+            out += number;
+            if (event.phase == 'X') {
+                std::snprintf(number, sizeof(number), ",\"dur\":%.3f}", micros(event.dur));
+                out += number;
+            } else {
+                std::snprintf(number, sizeof(number), ",\"args\":{\"value\":%.17g}}", event.value);
+                out += number;
+            }
+        }
+        out += "\n]}\n";
+
+        return io::writeFile(path_, out);
+    }
+
+private:
+    struct Event {
+        char phase;
+        const char* name;
+        Clock::duration ts;
+        Clock::duration dur;
+        double value;
+        unsigned thread;
+    };
+
+    static double micros(Clock::duration duration) {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    }
+
+    static void appendEscaped(std::string& out, const char* str) {
+        for (; *str; ++str) {
+            const char c = *str;
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out += ' ';
+            } else {
+                out += c;
+            }
+        }
+    }
+
+    unsigned threadIndex() {
+        return threads_.emplace(std::this_thread::get_id(), static_cast<unsigned>(threads_.size()))
+            .first->second;
+    }
+
+    const std::string path_;
+    const Clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+    std::unordered_map<std::string, int64_t> counters_;
+    std::unordered_map<std::thread::id, unsigned> threads_;
+};
+
+} // namespace trace
+} // namespace base
+} // namespace mapbox
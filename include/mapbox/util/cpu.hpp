@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "mapbox/platform.hpp"
+
+#if MB_ARCH_IS_X86
+#    if MB_COMPILER == MB_COMPILER_MSVC
+#        include <intrin.h>
+#    else
+#        include <cpuid.h>
+#    endif
+#elif MB_ARCH == MB_ARCH_ARM && (MB_PLATFORM_IS_LINUX || MB_PLATFORM_IS_ANDROID)
+#    include <sys/auxv.h>
+#endif
+
+namespace mapbox {
+namespace base {
+
+/**
+ * @brief Instruction set extensions, combinable with `|`.
+ */
+enum class CPUFeature : uint32_t {
+    None = 0,
+    SSE2 = 1u << 0,
+    SSSE3 = 1u << 1,
+    SSE41 = 1u << 2,
+    SSE42 = 1u << 3,
+    POPCNT = 1u << 4,
+    AVX = 1u << 5,
+    AVX2 = 1u << 6,
+    FMA = 1u << 7,
+    BMI2 = 1u << 8,
+    AVX512F = 1u << 9,
+    AVX512BW = 1u << 10,
+    AVX512VL = 1u << 11,
+    NEON = 1u << 16,
+};
+
+constexpr CPUFeature operator|(CPUFeature lhs, CPUFeature rhs) {
+    return static_cast<CPUFeature>(static_cast<uint32_t>(lhs) | static_cast<uint32_t>(rhs));
+}
+
+constexpr CPUFeature operator&(CPUFeature lhs, CPUFeature rhs) {
+    return static_cast<CPUFeature>(static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs));
+}
+
+/// @cond internal
+namespace internal {
+namespace cpu {
+
+#if MB_ARCH_IS_X86
+
+struct Registers {
+    uint32_t eax;
+    uint32_t ebx;
+    uint32_t ecx;
+    uint32_t edx;
+};
+
+inline Registers cpuid(uint32_t leaf) {
+    Registers regs{};
+#    if MB_COMPILER == MB_COMPILER_MSVC
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), 0);
+    regs = Registers{static_cast<uint32_t>(info[0]),
+                     static_cast<uint32_t>(info[1]),
+                     static_cast<uint32_t>(info[2]),
+                     static_cast<uint32_t>(info[3])};
+#    else
+    __cpuid_count(leaf, 0, regs.eax, regs.ebx, regs.ecx, regs.edx);
+#    endif
+    return regs;
+}
+
+// Register state enabled by the OS (XCR0).
+inline uint64_t xgetbv() {
+#    if MB_COMPILER == MB_COMPILER_MSVC
+    return _xgetbv(0);
+#    else
+    uint32_t eax = 0;
+    uint32_t edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (uint64_t{edx} << 32) | eax;
+#    endif
+}
+
+inline CPUFeature detect() {
+    const auto bit = [](uint32_t reg, uint32_t index) { return ((reg >> index) & 1u) != 0; };
+    uint32_t features = 0;
+
+    const uint32_t maxLeaf = cpuid(0).eax;
+    if (maxLeaf < 1) return CPUFeature::None;
+
+    const Registers leaf1 = cpuid(1);
+    if (bit(leaf1.edx, 26)) features |= static_cast<uint32_t>(CPUFeature::SSE2);
+    if (bit(leaf1.ecx, 9)) features |= static_cast<uint32_t>(CPUFeature::SSSE3);
+    if (bit(leaf1.ecx, 19)) features |= static_cast<uint32_t>(CPUFeature::SSE41);
+    if (bit(leaf1.ecx, 20)) features |= static_cast<uint32_t>(CPUFeature::SSE42);
+    if (bit(leaf1.ecx, 23)) features |= static_cast<uint32_t>(CPUFeature::POPCNT);
+
+    // AVX and AVX-512 also need the OS to save the wider registers.
+    const uint64_t xcr0 = bit(leaf1.ecx, 27) ? xgetbv() : 0;
+    const bool avxState = (xcr0 & 0x6) == 0x6;
+    const bool avx512State = (xcr0 & 0xe6) == 0xe6;
+
+    if (avxState && bit(leaf1.ecx, 28)) features |= static_cast<uint32_t>(CPUFeature::AVX);
+    if (avxState && bit(leaf1.ecx, 12)) features |= static_cast<uint32_t>(CPUFeature::FMA);
+
+    if (maxLeaf >= 7) {
+        const Registers leaf7 = cpuid(7);
+        if (avxState && bit(leaf7.ebx, 5)) features |= static_cast<uint32_t>(CPUFeature::AVX2);
+        if (bit(leaf7.ebx, 8)) features |= static_cast<uint32_t>(CPUFeature::BMI2);
+        if (avx512State && bit(leaf7.ebx, 16)) features |= static_cast<uint32_t>(CPUFeature::AVX512F);
+        if (avx512State && bit(leaf7.ebx, 30)) features |= static_cast<uint32_t>(CPUFeature::AVX512BW);
+        if (avx512State && bit(leaf7.ebx, 31)) features |= static_cast<uint32_t>(CPUFeature::AVX512VL);
+    }
+
+    return static_cast<CPUFeature>(features);
+}
+
+#elif MB_ARCH == MB_ARCH_ARM64
+
+inline CPUFeature detect() {
+    // Advanced SIMD is mandatory on ARMv8-A.
+    return CPUFeature::NEON;
+}
+
+#elif MB_ARCH == MB_ARCH_ARM
+
+inline CPUFeature detect() {
+#    if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return CPUFeature::NEON;
+#    elif (MB_PLATFORM_IS_LINUX || MB_PLATFORM_IS_ANDROID) && defined(AT_HWCAP)
+    constexpr unsigned long kHwcapNeon = 1ul << 12; // HWCAP_NEON
+    return (getauxval(AT_HWCAP) & kHwcapNeon) != 0 ? CPUFeature::NEON : CPUFeature::None;
+#    else
+    return CPUFeature::None;
+#    endif
+}
+
+#else
+
+inline CPUFeature detect() {
+    return CPUFeature::None;
+}
+
+#endif
+
+} // namespace cpu
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Returns the instruction set extensions usable on this CPU.
+ *
+ * The CPU is queried once, on the first call. Extensions that need OS
+ * support, like AVX, are only reported when the OS enables them.
+ */
+inline CPUFeature cpuFeatures() {
+    static const CPUFeature features = internal::cpu::detect();
+    return features;
+}
+
+/**
+ * @brief Returns whether all the given \a features are usable on this CPU.
+ */
+inline bool cpuSupports(CPUFeature features) {
+    return (cpuFeatures() & features) == features;
+}
+
+/**
+ * @brief Picks an implementation of a function based on the CPU features.
+ *
+ * Kernels are registered with the features they need, from the most
+ * portable to the fastest one, and \c select() returns the last registered
+ * kernel the CPU can run, or the fallback. Selection is meant to happen
+ * once, typically when initializing a function-local static:
+ *
+ * @code
+ * static const auto sum = CPUDispatch<SumFn>(scalar::sum)
+ *                             .add(CPUFeature::SSE41, sse41::sum)
+ *                             .add(CPUFeature::AVX2 | CPUFeature::FMA, avx2::sum)
+ *                             .select();
+ * @endcode
+ */
+template <typename TFunction>
+class CPUDispatch {
+public:
+    explicit CPUDispatch(TFunction fallback) : fallback_(std::move(fallback)) {}
+
+    /**
+     * @brief Registers \a function for the CPUs supporting all the
+     * \a required features.
+     */
+    CPUDispatch& add(CPUFeature required, TFunction function) {
+        kernels_.emplace_back(required, std::move(function));
+        return *this;
+    }
+
+    /**
+     * @brief Returns the preferred kernel runnable with the \a available
+     * features, which default to the ones of this CPU.
+     */
+    TFunction select(CPUFeature available = cpuFeatures()) const {
+        for (auto it = kernels_.rbegin(); it != kernels_.rend(); ++it) {
+            if ((available & it->first) == it->first) {
+                return it->second;
+            }
+        }
+        return fallback_;
+    }
+
+private:
+    TFunction fallback_;
+    std::vector<std::pair<CPUFeature, TFunction>> kernels_;
+};
+
+} // namespace base
+} // namespace mapbox
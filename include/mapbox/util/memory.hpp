@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "mapbox/platform.hpp"
+
+namespace mapbox {
+namespace base {
+
+/**
+ * @brief Interface of a source of memory, like C++17
+ * `std::pmr::memory_resource`.
+ */
+class MemoryResource {
+public:
+    virtual ~MemoryResource() = default;
+
+    /**
+     * @brief Allocates \a bytes bytes aligned to \a alignment, a power of
+     * two. Throws \c std::bad_alloc on failure.
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        return doAllocate(bytes, alignment);
+    }
+
+    /**
+     * @brief Releases memory returned by \c allocate() with the same
+     * \a bytes and \a alignment.
+     */
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        doDeallocate(ptr, bytes, alignment);
+    }
+
+    /**
+     * @brief Whether memory allocated by this resource can be released by
+     * \a other and vice versa.
+     */
+    bool isEqual(const MemoryResource& other) const noexcept { return doIsEqual(other); }
+
+protected:
+    virtual void* doAllocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) = 0;
+    virtual bool doIsEqual(const MemoryResource& other) const noexcept { return this == &other; }
+};
+
+/// @cond internal
+namespace internal {
+namespace memory {
+
+inline std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+class NewDeleteResource final : public MemoryResource {
+protected:
+    // `operator new` only guarantees the fundamental alignment before C++17,
+    // stricter alignments over-allocate and keep the original pointer in
+    // front of the returned block.
+    void* doAllocate(std::size_t bytes, std::size_t alignment) override {
+        if (alignment <= alignof(std::max_align_t)) {
+            return ::operator new(bytes);
+        }
+        void* raw = ::operator new(bytes + alignment + sizeof(void*));
+        const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*); // NOLINT
+        void* aligned = reinterpret_cast<void*>(alignUp(start, alignment));                // NOLINT
+        static_cast<void**>(aligned)[-1] = raw;
+        return aligned;
+    }
+
+    void doDeallocate(void* ptr, std::size_t, std::size_t alignment) override {
+        if (alignment <= alignof(std::max_align_t)) {
+            ::operator delete(ptr);
+        } else {
+            ::operator delete(static_cast<void**>(ptr)[-1]);
+        }
+    }
+
+    bool doIsEqual(const MemoryResource& other) const noexcept override {
+        return dynamic_cast<const NewDeleteResource*>(&other) != nullptr;
+    }
+};
+
+inline std::size_t threadSlot() {
+    static std::atomic_size_t nextSlot{0u};
+    thread_local const std::size_t slot = nextSlot++;
+    return slot;
+}
+
+} // namespace memory
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Resource allocating with global `operator new` and `operator delete`.
+ */
+inline MemoryResource* newDeleteResource() noexcept {
+    static internal::memory::NewDeleteResource instance;
+    return &instance;
+}
+
+/**
+ * @brief Bump allocator releasing its memory all at once.
+ *
+ * Allocations are carved from a buffer, and from chunks of growing size
+ * taken from the upstream resource once the buffer is exhausted.
+ * \c deallocate() does nothing; the memory is given back by \c release()
+ * or when the resource is destroyed. Meant for short-lived data, like the
+ * one built while processing a tile or a frame.
+ *
+ * Not thread-safe.
+ */
+class MonotonicBufferResource final : public MemoryResource {
+public:
+    /**
+     * @brief Creates an arena getting its chunks from \a upstream, the first
+     * one being \a initialSize bytes large.
+     */
+    explicit MonotonicBufferResource(std::size_t initialSize = 1024,
+                                     MemoryResource* upstream = newDeleteResource())
+        : upstream_(upstream), nextSize_(std::max<std::size_t>(initialSize, 64u)) {}
+
+    /**
+     * @brief Creates an arena allocating from \a buffer first, which must
+     * outlive the arena.
+     */
+    MonotonicBufferResource(void* buffer, std::size_t size, MemoryResource* upstream = newDeleteResource())
+        : upstream_(upstream),
+          buffer_(static_cast<char*>(buffer)),
+          bufferSize_(size),
+          current_(buffer_),
+          end_(buffer_ + size),
+          nextSize_(std::max<std::size_t>(size * 2, 64u)) {}
+
+    MonotonicBufferResource(const MonotonicBufferResource&) = delete;
+    MonotonicBufferResource& operator=(const MonotonicBufferResource&) = delete;
+
+    ~MonotonicBufferResource() override { release(); }
+
+    /**
+     * @brief Releases all the allocated memory, invalidating all the
+     * allocations made so far.
+     */
+    void release() {
+        while (chunks_) {
+            Chunk* chunk = chunks_;
+            chunks_ = chunk->next;
+            upstream_->deallocate(chunk, chunk->size, alignof(Chunk));
+        }
+        current_ = buffer_;
+        end_ = buffer_ + bufferSize_;
+    }
+
+    MemoryResource* upstream() const noexcept { return upstream_; }
+
+protected:
+    void* doAllocate(std::size_t bytes, std::size_t alignment) override {
+        if (void* ptr = bump(bytes, alignment)) {
+            return ptr;
+        }
+
+        const std::size_t size = std::max(nextSize_, internal::memory::alignUp(sizeof(Chunk), alignment) + bytes);
+        auto* chunk = static_cast<Chunk*>(upstream_->allocate(size, alignof(Chunk)));
+        chunk->next = chunks_;
+        chunk->size = size;
+        chunks_ = chunk;
+        current_ = reinterpret_cast<char*>(chunk) + sizeof(Chunk); // NOLINT
+        end_ = reinterpret_cast<char*>(chunk) + size;              // NOLINT
+        nextSize_ = size * 2;
+
+        void* ptr = bump(bytes, alignment);
+        assert(ptr);
+        return ptr;
+    }
+
+    void doDeallocate(void*, std::size_t, std::size_t) override {}
+
+private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        std::size_t size;
+    };
+
+    void* bump(std::size_t bytes, std::size_t alignment) {
+        if (!current_) return nullptr;
+        const auto address = reinterpret_cast<std::uintptr_t>(current_); // NOLINT
+        const std::size_t padding = internal::memory::alignUp(address, alignment) - address;
+        if (padding + bytes > static_cast<std::size_t>(end_ - current_)) return nullptr;
+        char* ptr = current_ + padding;
+        current_ = ptr + bytes;
+        return ptr;
+    }
+
+    MemoryResource* const upstream_;
+    char* const buffer_ = nullptr;
+    const std::size_t bufferSize_ = 0u;
+    char* current_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t nextSize_;
+    Chunk* chunks_ = nullptr;
+};
+
+/**
+ * @brief Thread-safe pool of fixed-size blocks.
+ *
+ * Requests up to \c blockSize() bytes are served from slabs of blocks taken
+ * from the upstream resource; larger or over-aligned requests go to the
+ * upstream resource directly. Freed blocks are kept in a fixed number of
+ * caches, each guarded by its own lock and padded to a cache line, and
+ * threads are spread over them by a per-thread slot. Threads mostly lock
+ * different caches, although several threads may share one. Caches exchange
+ * blocks with a shared free list in batches.
+ *
+ * Slabs are returned to the upstream resource when the pool is destroyed.
+ */
+class PoolResource final : public MemoryResource {
+public:
+    /**
+     * @param blockSize size of the blocks, rounded up to the fundamental
+     * alignment.
+     * @param blocksPerSlab number of blocks allocated at once from
+     * \a upstream.
+     */
+    explicit PoolResource(std::size_t blockSize,
+                          std::size_t blocksPerSlab = 256,
+                          MemoryResource* upstream = newDeleteResource())
+        : upstream_(upstream),
+          blockSize_(internal::memory::alignUp(std::max(blockSize, sizeof(FreeBlock)), alignof(std::max_align_t))),
+          blocksPerSlab_(std::max<std::size_t>(blocksPerSlab, 1u)) {}
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource() override {
+        for (void* slab : slabs_) {
+            upstream_->deallocate(slab, blockSize_ * blocksPerSlab_);
+        }
+    }
+
+    std::size_t blockSize() const noexcept { return blockSize_; }
+
+    MemoryResource* upstream() const noexcept { return upstream_; }
+
+protected:
+    void* doAllocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes > blockSize_ || alignment > alignof(std::max_align_t)) {
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        Cache& cache = caches_[internal::memory::threadSlot() % kCaches];
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if (!cache.head) {
+            refill(cache);
+        }
+        FreeBlock* block = cache.head;
+        cache.head = block->next;
+        cache.count--;
+        return block;
+    }
+
+    void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        if (bytes > blockSize_ || alignment > alignof(std::max_align_t)) {
+            upstream_->deallocate(ptr, bytes, alignment);
+            return;
+        }
+
+        Cache& cache = caches_[internal::memory::threadSlot() % kCaches];
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = cache.head;
+        cache.head = block;
+        if (++cache.count > 2 * kBatch) {
+            spill(cache);
+        }
+    }
+
+private:
+    static constexpr std::size_t kCaches = 16;
+    static constexpr std::size_t kBatch = 32;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct CacheData {
+        std::mutex mutex;
+        FreeBlock* head = nullptr;
+        std::size_t count = 0u;
+    };
+
+    // Padded so that threads locking neighbouring caches share fewer lines.
+    // Padding is used rather than `alignas()`, as `new` does not support
+    // over-aligned types before C++17.
+    struct Cache : CacheData {
+        char padding[MB_CACHE_LINE_SIZE - sizeof(CacheData) % MB_CACHE_LINE_SIZE];
+    };
+
+    // Moves a batch of blocks from the shared free list, or from a new slab,
+    // to the empty `cache`.
+    void refill(Cache& cache) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_) {
+            auto* slab = static_cast<char*>(upstream_->allocate(blockSize_ * blocksPerSlab_));
+            slabs_.push_back(slab);
+            for (std::size_t i = blocksPerSlab_; i-- > 0;) {
+                auto* block = reinterpret_cast<FreeBlock*>(slab + i * blockSize_); // NOLINT
+                block->next = free_;
+                free_ = block;
+            }
+        }
+        while (free_ && cache.count < kBatch) {
+            FreeBlock* block = free_;
+            free_ = block->next;
+            block->next = cache.head;
+            cache.head = block;
+            cache.count++;
+        }
+    }
+
+    // Moves a batch of blocks from `cache` to the shared free list.
+    void spill(Cache& cache) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (cache.count > kBatch) {
+            FreeBlock* block = cache.head;
+            cache.head = block->next;
+            block->next = free_;
+            free_ = block;
+            cache.count--;
+        }
+    }
+
+    MemoryResource* const upstream_;
+    const std::size_t blockSize_;
+    const std::size_t blocksPerSlab_;
+    Cache caches_[kCaches];
+    std::mutex mutex_;
+    FreeBlock* free_ = nullptr;
+    std::vector<void*> slabs_;
+};
+
+/**
+ * @brief Standard allocator allocating from a \c MemoryResource, like
+ * C++17 `std::pmr::polymorphic_allocator`, for use with the standard
+ * containers.
+ */
+template <typename T>
+class PolymorphicAllocator {
+public:
+    using value_type = T;
+
+    PolymorphicAllocator() noexcept : resource_(newDeleteResource()) {}
+    PolymorphicAllocator(MemoryResource* resource) noexcept : resource_(resource) { assert(resource_); } // NOLINT
+
+    template <typename U>
+    PolymorphicAllocator(const PolymorphicAllocator<U>& other) noexcept : resource_(other.resource()) {} // NOLINT
+
+    T* allocate(std::size_t count) { return static_cast<T*>(resource_->allocate(count * sizeof(T), alignof(T))); }
+
+    void deallocate(T* ptr, std::size_t count) { resource_->deallocate(ptr, count * sizeof(T), alignof(T)); }
+
+    MemoryResource* resource() const noexcept { return resource_; }
+
+private:
+    MemoryResource* resource_;
+};
+
+template <typename T, typename U>
+bool operator==(const PolymorphicAllocator<T>& lhs, const PolymorphicAllocator<U>& rhs) noexcept {
+    return lhs.resource() == rhs.resource() || lhs.resource()->isEqual(*rhs.resource());
+}
+
+template <typename T, typename U>
+bool operator!=(const PolymorphicAllocator<T>& lhs, const PolymorphicAllocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // namespace base
+} // namespace mapbox
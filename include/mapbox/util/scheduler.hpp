@@ -0,0 +1,340 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mapbox/std/weak.hpp"
+#include "mapbox/util/trace.hpp"
+#include "mapbox/util/unique_function.hpp"
+
+namespace mapbox {
+namespace base {
+
+/**
+ * @brief Priority of a task run by a \c Scheduler.
+ */
+enum class TaskPriority : uint8_t { High, Normal, Low };
+
+/**
+ * @brief Work-stealing thread pool.
+ *
+ * Every worker thread owns a deque of tasks per priority. Tasks scheduled
+ * from a worker go to its own deque and are run last-in first-out, which
+ * keeps nested work hot in cache; tasks scheduled from other threads go to
+ * a shared queue. Idle workers take tasks from the shared queue and then
+ * steal the oldest tasks of the other workers.
+ *
+ * Higher priority tasks are picked first, on a best-effort basis: a
+ * worker does not preempt a running task.
+ *
+ * Tasks must not throw. Pending tasks are run before the destructor
+ * returns.
+ */
+class Scheduler {
+public:
+    using Task = UniqueFunction<void()>;
+
+    /**
+     * @brief Starts \a threads worker threads, `0` meaning
+     * `std::thread::hardware_concurrency()`.
+     */
+    explicit Scheduler(std::size_t threads = 0)
+        : threadCount_(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+        queues_.reserve(threadCount_ + 1);
+        for (std::size_t i = 0; i <= threadCount_; ++i) {
+            queues_.emplace_back(std::make_unique<Queue>());
+        }
+        workers_.reserve(threadCount_);
+        for (std::size_t i = 0; i < threadCount_; ++i) {
+            workers_.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wakeup_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Process-wide scheduler, for components that share one pool
+     * instead of starting their own threads.
+     */
+    static Scheduler& shared() {
+        static Scheduler instance;
+        return instance;
+    }
+
+    /**
+     * @brief Number of worker threads.
+     */
+    std::size_t threadCount() const { return threadCount_; }
+
+    /**
+     * @brief Schedules \a task to be run by a worker thread.
+     */
+    void schedule(Task task, TaskPriority priority = TaskPriority::Normal) {
+        Queue& queue = *queues_[currentIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks[static_cast<std::size_t>(priority)].push_back(std::move(task));
+            queue.size++;
+        }
+        pending_++;
+        if (sleeping_ > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wakeup_.notify_one();
+        }
+    }
+
+    /**
+     * @brief Schedules \a task to be called with the object \a owner points
+     * to, which is kept alive during the call.
+     *
+     * The task is skipped if the object is gone by the time it runs.
+     */
+    template <typename T, typename Fn>
+    void schedule(WeakPtr<T> owner, Fn task, TaskPriority priority = TaskPriority::Normal) {
+        schedule(
+            [owner = std::move(owner), task = std::move(task)]() mutable {
+                WeakPtrGuard guard = owner.lock();
+                if (T* object = owner.get()) {
+                    task(*object);
+                }
+            },
+            priority);
+    }
+
+    /**
+     * @brief Runs one pending task on the calling thread, if any.
+     *
+     * Lets a thread waiting for tasks to complete help instead of blocking.
+     *
+     * @return false if there was no task to run.
+     */
+    bool runPendingTask() {
+        Task task;
+        if (!take(currentIndex(), task)) return false;
+        MB_TRACE_SCOPE("Scheduler::task");
+        task();
+        return true;
+    }
+
+private:
+    static constexpr std::size_t kPriorities = 3;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks[kPriorities];
+        // Lets thieves skip empty queues without locking them.
+        std::atomic_size_t size{0u};
+    };
+
+    struct Worker {
+        const Scheduler* scheduler;
+        std::size_t index;
+    };
+
+    static Worker& currentWorker() {
+        thread_local Worker worker{nullptr, 0u};
+        return worker;
+    }
+
+    // Index of the queue of the calling thread, the last one being the shared
+    // queue of the threads that are not workers of this scheduler.
+    std::size_t currentIndex() const {
+        const Worker& worker = currentWorker();
+        return worker.scheduler == this ? worker.index : threadCount_;
+    }
+
+    bool take(std::size_t self, Task& task) {
+        if (pending_ == 0) return false;
+        const std::size_t shared = threadCount_;
+        for (std::size_t priority = 0; priority < kPriorities; ++priority) {
+            // Own queue first, newest task first; then the shared queue and the
+            // other workers, oldest task first.
+            if (self != shared && pop(self, priority, true, task)) return true;
+            if (pop(shared, priority, false, task)) return true;
+            for (std::size_t i = 1; i <= shared; ++i) {
+                const std::size_t victim = (self + i) % (shared + 1);
+                if (victim != shared && pop(victim, priority, false, task)) {
+                    MB_TRACE_COUNTER("Scheduler.steals", 1);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool pop(std::size_t index, std::size_t priority, bool newest, Task& task) {
+        Queue& queue = *queues_[index];
+        if (queue.size == 0) return false;
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        std::deque<Task>& tasks = queue.tasks[priority];
+        if (tasks.empty()) return false;
+        if (newest) {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+        } else {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        queue.size--;
+        pending_--;
+        return true;
+    }
+
+    void run(std::size_t index) {
+        currentWorker() = Worker{this, index};
+        Task task;
+        while (true) {
+            if (take(index, task)) {
+                MB_TRACE_SCOPE("Scheduler::task");
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleeping_++;
+            wakeup_.wait(lock, [this] { return pending_ > 0 || stopping_; });
+            sleeping_--;
+            if (stopping_ && pending_ == 0) return;
+        }
+    }
+
+    const std::size_t threadCount_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic_size_t pending_{0u};
+    std::atomic_size_t sleeping_{0u};
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool stopping_ = false;
+};
+
+/**
+ * @brief Calls \a body for every index in [\a begin, \a end) on the
+ * workers of \a scheduler and on the calling thread.
+ *
+ * Indices are handed out in chunks of \a grain. The call returns once all
+ * of them were processed, running other pending tasks while waiting, so it
+ * can be nested in tasks of the same scheduler. If \a body throws, the
+ * remaining chunks are skipped and the first exception is rethrown.
+ */
+template <typename Fn>
+void parallelFor(Scheduler& scheduler, std::size_t begin, std::size_t end, Fn&& body, std::size_t grain = 1) {
+    if (begin >= end) return;
+    grain = std::max<std::size_t>(grain, 1u);
+    const std::size_t chunks = (end - begin + grain - 1) / grain;
+
+    // Shared with the helper tasks, which may only run after this call
+    // returned; they do not touch `body` once all chunks were claimed.
+    struct State {
+        std::atomic_size_t next{0u};
+        std::atomic_size_t done{0u};
+        std::atomic_bool failed{false};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    auto* fn = &body;
+
+    const auto work = [state, fn, begin, end, grain, chunks] {
+        for (std::size_t chunk = state->next++; chunk < chunks; chunk = state->next++) {
+            if (!state->failed) {
+                try {
+                    const std::size_t last = std::min(end, begin + (chunk + 1) * grain);
+                    for (std::size_t i = begin + chunk * grain; i < last; ++i) {
+                        (*fn)(i);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->errorMutex);
+                    if (!state->error) state->error = std::current_exception();
+                    state->failed = true;
+                }
+            }
+            state->done++;
+        }
+    };
+
+    const std::size_t helpers = std::min(chunks - 1, scheduler.threadCount());
+    for (std::size_t i = 0; i < helpers; ++i) {
+        scheduler.schedule(work);
+    }
+    work();
+
+    while (state->done < chunks) {
+        if (!scheduler.runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+/**
+ * @brief Sorts [\a first, \a last) with \a comp, sorting slices in
+ * parallel on \a scheduler and merging them pairwise. Not stable.
+ */
+template <typename RandomIt, typename Compare>
+void parallelSort(Scheduler& scheduler, RandomIt first, RandomIt last, Compare comp) {
+    constexpr std::size_t kMinSlice = 1u << 12;
+    const auto size = static_cast<std::size_t>(std::distance(first, last));
+
+    std::size_t slices = 1;
+    while (slices < scheduler.threadCount() + 1 && size / (slices * 2) >= kMinSlice) {
+        slices *= 2;
+    }
+    if (slices == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<RandomIt> bounds(slices + 1);
+    for (std::size_t i = 0; i <= slices; ++i) {
+        bounds[i] = first + static_cast<std::ptrdiff_t>(size * i / slices);
+    }
+
+    parallelFor(scheduler, 0, slices, [&](std::size_t i) { std::sort(bounds[i], bounds[i + 1], comp); });
+    for (std::size_t width = 1; width < slices; width *= 2) {
+        parallelFor(scheduler, 0, slices / (width * 2), [&](std::size_t i) {
+            const std::size_t lo = i * width * 2;
+            std::inplace_merge(bounds[lo], bounds[lo + width], bounds[lo + width * 2], comp);
+        });
+    }
+}
+
+/**
+ * @brief Sorts [\a first, \a last) with `operator<` in parallel.
+ */
+template <typename RandomIt>
+void parallelSort(Scheduler& scheduler, RandomIt first, RandomIt last) {
+    parallelSort(scheduler, first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+} // namespace base
+} // namespace mapbox
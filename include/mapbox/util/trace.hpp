@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Enables the instrumentation macros below. When disabled (the default),
+ * the macros expand to nothing and their arguments are not evaluated.
+ *
+ * Must be defined consistently across the whole program.
+ */
+#ifndef MB_ENABLE_TRACING
+#    define MB_ENABLE_TRACING 0
+#endif
+
+namespace mapbox {
+namespace base {
+namespace trace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Receives the instrumentation events.
+ *
+ * Methods are called from the instrumented threads, and must be
+ * thread-safe and not throw. Event names are string literals.
+ */
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    /**
+     * @brief A scope named \a name ran from \a start to \a end.
+     */
+    virtual void duration(const char* name, Clock::time_point start, Clock::time_point end) = 0;
+
+    /**
+     * @brief The counter named \a name changed by \a delta.
+     */
+    virtual void counter(const char* name, int64_t delta) = 0;
+
+    /**
+     * @brief A sample \a value was recorded in the histogram named \a name.
+     */
+    virtual void histogram(const char* name, double value) = 0;
+};
+
+/// @cond internal
+namespace internal {
+
+inline std::atomic<Sink*>& sink() {
+    static std::atomic<Sink*> instance{nullptr};
+    return instance;
+}
+
+} // namespace internal
+/// @endcond
+
+/**
+ * @brief Installs the sink receiving the events, or removes it if
+ * \a sink is null.
+ *
+ * The sink is not owned and must outlive the instrumented calls that may
+ * still be running when it is removed.
+ */
+inline void setSink(Sink* sink) {
+    internal::sink().store(sink, std::memory_order_release);
+}
+
+/**
+ * @brief Returns the installed sink, if any.
+ */
+inline Sink* getSink() {
+    return internal::sink().load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Changes the counter named \a name by \a delta.
+ */
+inline void counter(const char* name, int64_t delta = 1) {
+    if (Sink* sink = getSink()) sink->counter(name, delta);
+}
+
+/**
+ * @brief Records \a value in the histogram named \a name.
+ */
+inline void histogram(const char* name, double value) {
+    if (Sink* sink = getSink()) sink->histogram(name, value);
+}
+
+/**
+ * @brief Reports the duration of its scope.
+ *
+ * The sink is looked up once, when the timer is created.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name) : name_(name), sink_(getSink()) {
+        if (sink_) start_ = Clock::now();
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        if (sink_) sink_->duration(name_, start_, Clock::now());
+    }
+
+private:
+    const char* name_;
+    Sink* sink_;
+    Clock::time_point start_;
+};
+
+} // namespace trace
+} // namespace base
+} // namespace mapbox
+
+#if MB_ENABLE_TRACING
+#    define MB_TRACE_CONCAT_IMPL(a, b) a##b
+#    define MB_TRACE_CONCAT(a, b) MB_TRACE_CONCAT_IMPL(a, b)
+#    define MB_TRACE_SCOPE(name) \
+        const ::mapbox::base::trace::ScopedTimer MB_TRACE_CONCAT(mbTraceScope, __LINE__)(name)
+#    define MB_TRACE_COUNTER(name, delta) ::mapbox::base::trace::counter(name, delta)
+#    define MB_TRACE_HISTOGRAM(name, value) ::mapbox::base::trace::histogram(name, value)
+#else
+#    define MB_TRACE_SCOPE(name) static_cast<void>(0)
+#    define MB_TRACE_COUNTER(name, delta) static_cast<void>(0)
+#    define MB_TRACE_HISTOGRAM(name, value) static_cast<void>(0)
+#endif
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
+#include "mapbox/util/memory.hpp"
+#include "mapbox/util/trace.hpp"
+
 namespace mapbox {
 namespace base {
 
@@ -17,6 +22,19 @@ public:
     TypeWrapper(T&& value) noexcept
         : storage_(new std::decay_t<T>(std::forward<T>(value)), cast_deleter<std::decay_t<T>>) {
         static_assert(!std::is_same<TypeWrapper, std::decay_t<T>>::value, "TypeWrapper must not wrap itself.");
+        MB_TRACE_COUNTER("TypeWrapper.allocations", 1);
+    }
+
+    /**
+     * @brief Wraps \a value in memory allocated from \a resource, which
+     * must outlive the wrapper.
+     */
+    template <typename T>
+    TypeWrapper(std::allocator_arg_t, MemoryResource* resource, T&& value)
+        : storage_(allocate<std::decay_t<T>>(resource, std::forward<T>(value)),
+                   resource_deleter<std::decay_t<T>>) {
+        static_assert(!std::is_same<TypeWrapper, std::decay_t<T>>::value, "TypeWrapper must not wrap itself.");
+        MB_TRACE_COUNTER("TypeWrapper.allocations", 1);
     }
 
     bool has_value() const noexcept { return static_cast<bool>(storage_); }
@@ -33,6 +51,39 @@ private:
     }
     static void noop_deleter(void*) noexcept {}
 
+    // Values allocated from a resource are preceded by the resource pointer,
+    // which keeps the wrapper the size of a plain owning pointer.
+    template <typename T>
+    static constexpr std::size_t resource_offset() {
+        return (sizeof(MemoryResource*) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+    template <typename T>
+    static constexpr std::size_t resource_alignment() {
+        return alignof(T) > alignof(MemoryResource*) ? alignof(T) : alignof(MemoryResource*);
+    }
+
+    template <typename T, typename U>
+    static void* allocate(MemoryResource* resource, U&& value) {
+        void* block = resource->allocate(resource_offset<T>() + sizeof(T), resource_alignment<T>());
+        void* ptr = static_cast<char*>(block) + resource_offset<T>();
+        try {
+            ::new (ptr) T(std::forward<U>(value));
+        } catch (...) {
+            resource->deallocate(block, resource_offset<T>() + sizeof(T), resource_alignment<T>());
+            throw;
+        }
+        ::new (block) MemoryResource*(resource);
+        return ptr;
+    }
+
+    template <typename T>
+    static void resource_deleter(void* ptr) noexcept {
+        static_cast<T*>(ptr)->~T();
+        void* block = static_cast<char*>(ptr) - resource_offset<T>();
+        MemoryResource* resource = *static_cast<MemoryResource**>(block);
+        resource->deallocate(block, resource_offset<T>() + sizeof(T), resource_alignment<T>());
+    }
+
     using storage_t = std::unique_ptr<void, void (*)(void*)>;
     storage_t storage_;
 };
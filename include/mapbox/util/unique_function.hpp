@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mapbox {
+namespace base {
+
+template <typename Signature, std::size_t InlineSize = 6 * sizeof(void*)>
+class UniqueFunction;
+
+/**
+ * @brief Move-only polymorphic function wrapper.
+ *
+ * Like \c std::function, but move-only, so it can hold move-only callables
+ * and moving it never touches reference counts of the captured state.
+ * Callables up to \a InlineSize bytes with a non-throwing move constructor
+ * are stored inline, without allocating; larger ones are allocated on the
+ * heap. The default size holds closures made by
+ * \c WeakPtrFactory::makeWeakMethod().
+ *
+ * @tparam R return type
+ * @tparam Args argument types
+ * @tparam InlineSize size of the inline storage, in bytes
+ */
+template <typename R, typename... Args, std::size_t InlineSize>
+class UniqueFunction<R(Args...), InlineSize> {
+public:
+    UniqueFunction() noexcept = default;
+    UniqueFunction(std::nullptr_t) noexcept {} // NOLINT
+
+    /**
+     * @brief Wraps \a fn, which becomes owned by the wrapper.
+     */
+    template <typename Fn,
+              typename F = std::decay_t<Fn>,
+              typename = std::enable_if_t<!std::is_same<F, UniqueFunction>::value && !std::is_member_pointer<F>::value &&
+                                          std::is_convertible<std::result_of_t<F&(Args...)>, R>::value>>
+    UniqueFunction(Fn&& fn) { // NOLINT misc-forwarding-reference-overload
+        if (isNull(fn)) return;
+        construct<F>(std::forward<Fn>(fn), std::integral_constant<bool, storesInline<F>()>());
+    }
+
+    UniqueFunction(UniqueFunction&& other) noexcept { moveFrom(other); }
+
+    UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    UniqueFunction& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    UniqueFunction(const UniqueFunction&) = delete;
+    UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+    ~UniqueFunction() { reset(); }
+
+    /**
+     * @brief Calls the wrapped callable, which must not be empty.
+     */
+    R operator()(Args... args) const {
+        assert(ops_);
+        return ops_->invoke(&storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    /**
+     * @brief Whether a callable of type \a F is stored without allocating.
+     */
+    template <typename F>
+    static constexpr bool storesInline() {
+        return sizeof(F) <= InlineSize && alignof(F) <= alignof(Storage) &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
+
+private:
+    using Storage = std::aligned_storage_t<InlineSize, alignof(std::max_align_t)>;
+
+    struct Ops {
+        R (*invoke)(void*, Args&&...);
+        void (*move)(void* to, void* from) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template <typename F>
+    struct InlineOps {
+        static F& get(void* storage) { return *static_cast<F*>(storage); }
+        static R invoke(void* storage, Args&&... args) { return get(storage)(std::forward<Args>(args)...); }
+        static void move(void* to, void* from) noexcept {
+            ::new (to) F(std::move(get(from)));
+            get(from).~F();
+        }
+        static void destroy(void* storage) noexcept { get(storage).~F(); }
+    };
+
+    template <typename F>
+    struct HeapOps {
+        static F*& get(void* storage) { return *static_cast<F**>(storage); }
+        static R invoke(void* storage, Args&&... args) { return (*get(storage))(std::forward<Args>(args)...); }
+        static void move(void* to, void* from) noexcept { ::new (to) F*(get(from)); }
+        static void destroy(void* storage) noexcept { delete get(storage); }
+    };
+
+    template <typename Impl>
+    static const Ops* ops() {
+        static const Ops table{Impl::invoke, Impl::move, Impl::destroy};
+        return &table;
+    }
+
+    template <typename F, typename Fn>
+    void construct(Fn&& fn, std::true_type /* inline */) {
+        ::new (&storage_) F(std::forward<Fn>(fn));
+        ops_ = ops<InlineOps<F>>();
+    }
+
+    template <typename F, typename Fn>
+    void construct(Fn&& fn, std::false_type /* inline */) {
+        ::new (&storage_) F*(new F(std::forward<Fn>(fn)));
+        ops_ = ops<HeapOps<F>>();
+    }
+
+    template <typename F>
+    static bool isNull(const F& fn) {
+        return isNull(fn, std::is_pointer<F>());
+    }
+    template <typename F>
+    static bool isNull(const F& fn, std::true_type /* pointer */) {
+        return fn == nullptr;
+    }
+    template <typename F>
+    static bool isNull(const F&, std::false_type /* pointer */) {
+        return false;
+    }
+
+    void moveFrom(UniqueFunction& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(&storage_, &other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    mutable Storage storage_;
+    const Ops* ops_ = nullptr;
+};
+
+} // namespace base
+} // namespace mapbox
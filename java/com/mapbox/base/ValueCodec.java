@@ -0,0 +1,250 @@
+package com.mapbox.base;
+
+import java.math.BigInteger;
+import java.nio.BufferUnderflowException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.Charset;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Java side of the {@code mapbox::base::Value} hand-off of
+ * {@code mapbox/jni/bulk.hpp}.
+ *
+ * <p>A value is handed over as one version byte ({@link #VERSION}, which
+ * matches {@code kValueFormatVersion}) followed by the
+ * {@code encodeValue()} encoding: a one byte type tag, then 0 null,
+ * 1 boolean (one byte), 2 uint64, 3 int64, 4 double, 5 string, 6 array or
+ * 7 object. Strings are a uint32 byte count followed by UTF-8 bytes, arrays
+ * a uint32 count followed by the values, objects a uint32 count followed by
+ * key strings and values. Numbers are little-endian.
+ *
+ * <p>Values map to {@code null}, {@link Boolean}, {@link Long}, {@link Double},
+ * {@link String}, {@link List} and {@link Map} with {@link String} keys.
+ * uint64 values above {@link Long#MAX_VALUE} decode to {@link BigInteger}.
+ * When encoding, {@link Byte}, {@link Short}, {@link Integer} and
+ * {@link Long} become int64, {@link Float} and {@link Double} become double,
+ * and {@link BigInteger} in the uint64 range becomes uint64.
+ */
+public final class ValueCodec {
+  /** Version of the format, the first byte of every encoded value. */
+  public static final byte VERSION = 1;
+
+  // Limits nesting like the native decoder does.
+  private static final int MAX_DEPTH = 64;
+
+  private static final byte NULL = 0;
+  private static final byte BOOLEAN = 1;
+  private static final byte UINT64 = 2;
+  private static final byte INT64 = 3;
+  private static final byte DOUBLE = 4;
+  private static final byte STRING = 5;
+  private static final byte ARRAY = 6;
+  private static final byte OBJECT = 7;
+
+  private static final Charset UTF_8 = Charset.forName("UTF-8");
+  private static final BigInteger UINT64_RANGE = BigInteger.ONE.shiftLeft(64);
+
+  private ValueCodec() {
+  }
+
+  /**
+   * Decodes a value from a {@code byte[]} returned by
+   * {@code valueToByteArray()}.
+   *
+   * @throws IllegalArgumentException if the array does not hold an encoded
+   *     value, or was encoded in another version of the format
+   */
+  public static Object decode(byte[] bytes) {
+    return decode(ByteBuffer.wrap(bytes));
+  }
+
+  /**
+   * Decodes a value from the remaining bytes of {@code buffer}, such as a
+   * buffer returned by {@code valueToByteBuffer()}. Does not change the
+   * position of {@code buffer}.
+   *
+   * @throws IllegalArgumentException if the buffer does not hold an encoded
+   *     value, or was encoded in another version of the format
+   */
+  public static Object decode(ByteBuffer buffer) {
+    ByteBuffer in = buffer.duplicate().order(ByteOrder.LITTLE_ENDIAN);
+    try {
+      if (in.get() != VERSION) {
+        throw new IllegalArgumentException("Unsupported encoded value version");
+      }
+      Object value = read(in, 0);
+      if (in.hasRemaining()) {
+        throw invalid();
+      }
+      return value;
+    } catch (BufferUnderflowException exception) {
+      throw invalid();
+    }
+  }
+
+  /**
+   * Encodes {@code value} into a {@code byte[]} for
+   * {@code valueFromByteArray()}.
+   *
+   * @throws IllegalArgumentException if {@code value} holds types that
+   *     cannot be encoded or is nested too deeply
+   */
+  public static byte[] encode(Object value) {
+    Writer writer = new Writer();
+    writer.write(value, 0);
+    return Arrays.copyOf(writer.buffer.array(), writer.buffer.position());
+  }
+
+  /**
+   * Encodes {@code value} into a direct {@link ByteBuffer} for
+   * {@code valueFromByteBuffer()}, which decodes it in place. The buffer has
+   * the exact size of the encoding, as the native side reads its whole
+   * capacity.
+   *
+   * @throws IllegalArgumentException if {@code value} holds types that
+   *     cannot be encoded or is nested too deeply
+   */
+  public static ByteBuffer encodeDirect(Object value) {
+    byte[] bytes = encode(value);
+    ByteBuffer buffer = ByteBuffer.allocateDirect(bytes.length).order(ByteOrder.LITTLE_ENDIAN);
+    buffer.put(bytes);
+    buffer.flip();
+    return buffer;
+  }
+
+  private static IllegalArgumentException invalid() {
+    return new IllegalArgumentException("Invalid encoded value");
+  }
+
+  private static Object read(ByteBuffer in, int depth) {
+    if (depth > MAX_DEPTH) {
+      throw invalid();
+    }
+    switch (in.get()) {
+      case NULL:
+        return null;
+      case BOOLEAN:
+        return in.get() != 0;
+      case UINT64: {
+        long value = in.getLong();
+        if (value >= 0) {
+          return value;
+        }
+        return BigInteger.valueOf(value).add(UINT64_RANGE);
+      }
+      case INT64:
+        return in.getLong();
+      case DOUBLE:
+        return in.getDouble();
+      case STRING:
+        return readString(in);
+      case ARRAY: {
+        int count = readCount(in);
+        List<Object> array = new ArrayList<>(count);
+        for (int i = 0; i < count; i++) {
+          array.add(read(in, depth + 1));
+        }
+        return array;
+      }
+      case OBJECT: {
+        int count = readCount(in);
+        Map<String, Object> object = new HashMap<>();
+        for (int i = 0; i < count; i++) {
+          String key = readString(in);
+          object.put(key, read(in, depth + 1));
+        }
+        return object;
+      }
+      default:
+        throw invalid();
+    }
+  }
+
+  // Every element takes at least one byte, which bounds bogus counts.
+  private static int readCount(ByteBuffer in) {
+    long count = in.getInt() & 0xffffffffL;
+    if (count > in.remaining()) {
+      throw invalid();
+    }
+    return (int) count;
+  }
+
+  private static String readString(ByteBuffer in) {
+    byte[] bytes = new byte[readCount(in)];
+    in.get(bytes);
+    return new String(bytes, UTF_8);
+  }
+
+  private static final class Writer {
+    ByteBuffer buffer = ByteBuffer.allocate(256).order(ByteOrder.LITTLE_ENDIAN);
+
+    Writer() {
+      buffer.put(VERSION);
+    }
+
+    void write(Object value, int depth) {
+      if (depth > MAX_DEPTH) {
+        throw new IllegalArgumentException("Value is nested too deeply");
+      }
+      if (value == null) {
+        reserve(1).put(NULL);
+      } else if (value instanceof Boolean) {
+        reserve(2).put(BOOLEAN).put((byte) ((Boolean) value ? 1 : 0));
+      } else if (value instanceof Long || value instanceof Integer || value instanceof Short
+          || value instanceof Byte) {
+        reserve(9).put(INT64).putLong(((Number) value).longValue());
+      } else if (value instanceof BigInteger) {
+        BigInteger integer = (BigInteger) value;
+        if (integer.signum() < 0 || integer.bitLength() > 64) {
+          throw new IllegalArgumentException("Integer is out of the uint64 range");
+        }
+        reserve(9).put(UINT64).putLong(integer.longValue());
+      } else if (value instanceof Double || value instanceof Float) {
+        reserve(9).put(DOUBLE).putDouble(((Number) value).doubleValue());
+      } else if (value instanceof String) {
+        reserve(1).put(STRING);
+        writeString((String) value);
+      } else if (value instanceof List) {
+        List<?> array = (List<?>) value;
+        reserve(5).put(ARRAY).putInt(array.size());
+        for (Object item : array) {
+          write(item, depth + 1);
+        }
+      } else if (value instanceof Map) {
+        Map<?, ?> object = (Map<?, ?>) value;
+        reserve(5).put(OBJECT).putInt(object.size());
+        for (Map.Entry<?, ?> property : object.entrySet()) {
+          if (!(property.getKey() instanceof String)) {
+            throw new IllegalArgumentException("Object keys must be strings");
+          }
+          writeString((String) property.getKey());
+          write(property.getValue(), depth + 1);
+        }
+      } else {
+        throw new IllegalArgumentException("Unsupported value type " + value.getClass().getName());
+      }
+    }
+
+    private void writeString(String value) {
+      byte[] bytes = value.getBytes(UTF_8);
+      reserve(4 + bytes.length).putInt(bytes.length).put(bytes);
+    }
+
+    // Grows the buffer to fit `size` more bytes.
+    private ByteBuffer reserve(int size) {
+      if (buffer.remaining() < size) {
+        int capacity = Math.max(buffer.capacity() * 2, buffer.position() + size);
+        ByteBuffer grown = ByteBuffer.allocate(capacity).order(ByteOrder.LITTLE_ENDIAN);
+        buffer.flip();
+        grown.put(buffer);
+        buffer = grown;
+      }
+      return buffer;
+    }
+  }
+}
@@ -4,7 +4,7 @@ set -eo pipefail
 
 mkdir build && pushd build
 export CC=${CCOMPILER} CXX=${CXXCOMPILER}
-cmake .. -DCMAKE_BUILD_TYPE=${BUILD_TYPE} -DBUILD_TESTING=ON
+cmake .. -DCMAKE_BUILD_TYPE=${BUILD_TYPE} -DBUILD_TESTING=ON ${CMAKE_ARGS}
 echo "travis_fold:start:MAKE"
 make --jobs=${JOBS}
 echo "travis_fold:end:MAKE"
@@ -0,0 +1,127 @@
+#include "mapbox/cheap_ruler/batch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using mapbox::base::BatchRuler;
+using mapbox::cheap_ruler::CheapRuler;
+
+namespace {
+
+const BatchRuler::Kernel kKernels[] = {
+    BatchRuler::Kernel::Scalar, BatchRuler::Kernel::SSE2, BatchRuler::Kernel::AVX2, BatchRuler::Kernel::NEON};
+
+struct Points {
+    explicit Points(std::size_t count) {
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<double> lon(-179.9, 179.9);
+        std::uniform_real_distribution<double> lat(30.0, 50.0);
+        for (std::size_t i = 0; i < count; ++i) {
+            lons.push_back(lon(generator));
+            lats.push_back(lat(generator));
+        }
+    }
+
+    std::vector<double> lons;
+    std::vector<double> lats;
+};
+
+} // namespace
+
+TEST(BatchRuler, Distances) {
+    CheapRuler ruler(40.0);
+    const Points a(1027);
+    const Points b(1027);
+
+    for (const auto kernel : kKernels) {
+        if (!BatchRuler::supported(kernel)) continue;
+        BatchRuler batch(ruler, kernel);
+        EXPECT_EQ(batch.kernel(), kernel);
+
+        std::vector<double> out(a.lons.size());
+        batch.distances(a.lons.data(), a.lats.data(), b.lons.data(), b.lats.data(), out.size(), out.data());
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            const double expected = ruler.distance({a.lons[i], a.lats[i]}, {b.lons[i], b.lats[i]});
+            EXPECT_NEAR(out[i], expected, expected * 1e-12) << i;
+        }
+
+        const mapbox::cheap_ruler::point origin{179.5, 40.0};
+        batch.distances(origin, b.lons.data(), b.lats.data(), out.size(), out.data());
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            const double expected = ruler.distance(origin, {b.lons[i], b.lats[i]});
+            EXPECT_NEAR(out[i], expected, expected * 1e-12) << i;
+        }
+    }
+}
+
+TEST(BatchRuler, Antimeridian) {
+    CheapRuler ruler(0.0);
+    const std::vector<double> lons1{179.0, -179.0, 540.0, 10.0, -190.0};
+    const std::vector<double> lats1{0.0, 0.0, 0.0, 0.0, 0.0};
+    const std::vector<double> lons2{-179.0, 179.0, 0.0, 10.0, 170.0};
+    const std::vector<double> lats2{0.0, 0.0, 1.0, 1.0, 0.0};
+
+    for (const auto kernel : kKernels) {
+        if (!BatchRuler::supported(kernel)) continue;
+        BatchRuler batch(ruler, kernel);
+        std::vector<double> out(lons1.size());
+        batch.distances(lons1.data(), lats1.data(), lons2.data(), lats2.data(), out.size(), out.data());
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            EXPECT_DOUBLE_EQ(out[i], ruler.distance({lons1[i], lats1[i]}, {lons2[i], lats2[i]})) << i;
+        }
+    }
+}
+
+TEST(BatchRuler, LineDistance) {
+    CheapRuler ruler(40.0, CheapRuler::Meters);
+    const Points points(999);
+
+    mapbox::cheap_ruler::line_string line;
+    for (std::size_t i = 0; i < points.lons.size(); ++i) {
+        line.emplace_back(points.lons[i], points.lats[i]);
+    }
+    const double expected = ruler.lineDistance(line);
+
+    for (const auto kernel : kKernels) {
+        if (!BatchRuler::supported(kernel)) continue;
+        BatchRuler batch(ruler, kernel);
+        EXPECT_NEAR(batch.lineDistance(points.lons.data(), points.lats.data(), points.lons.size()),
+                    expected,
+                    expected * 1e-12);
+        EXPECT_EQ(batch.lineDistance(points.lons.data(), points.lats.data(), 1), 0.0);
+    }
+}
+
+TEST(BatchRuler, InsideBBox) {
+    CheapRuler ruler(40.0);
+    const Points points(1001);
+    const mapbox::cheap_ruler::box bbox({-30.0, 35.0}, {60.0, 45.0});
+    const mapbox::cheap_ruler::box wrapped({170.0, 35.0}, {-170.0, 45.0});
+
+    for (const auto kernel : kKernels) {
+        if (!BatchRuler::supported(kernel)) continue;
+        BatchRuler batch(ruler, kernel);
+
+        for (const auto& box : {bbox, wrapped}) {
+            std::vector<uint8_t> out(points.lons.size());
+            std::size_t expectedCount = 0;
+            const std::size_t count =
+                batch.insideBBox(points.lons.data(), points.lats.data(), out.size(), box, out.data());
+            for (std::size_t i = 0; i < out.size(); ++i) {
+                const bool expected = ruler.insideBBox({points.lons[i], points.lats[i]}, box);
+                expectedCount += expected;
+                EXPECT_EQ(out[i] != 0, expected) << i;
+            }
+            EXPECT_EQ(count, expectedCount);
+            EXPECT_EQ(batch.insideBBox(points.lons.data(), points.lats.data(), out.size(), box), expectedCount);
+        }
+    }
+}
+
+TEST(BatchRuler, BestKernel) {
+    EXPECT_TRUE(BatchRuler::supported(BatchRuler::bestKernel()));
+    EXPECT_TRUE(BatchRuler::supported(BatchRuler::Kernel::Scalar));
+    EXPECT_EQ(BatchRuler(40.0).kernel(), BatchRuler::bestKernel());
+}
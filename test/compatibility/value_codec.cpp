@@ -0,0 +1,70 @@
+#include "mapbox/compatibility/value_codec.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace mapbox::base;
+
+namespace {
+
+Value makeValue(std::size_t count) {
+    ValueArray features;
+    for (std::size_t i = 0; i < count; ++i) {
+        ValueObject properties;
+        properties["id"] = Value(uint64_t{i});
+        properties["name"] = Value(std::string("feature ") + std::to_string(i));
+        properties["height"] = Value(static_cast<double>(i) / 4);
+        properties["offset"] = Value(-static_cast<int64_t>(i));
+        properties["visible"] = Value(i % 2 == 0);
+        properties["tags"] = Value(ValueArray{Value(std::string("a")), Value(), Value(ValueObject{})});
+        features.emplace_back(std::move(properties));
+    }
+    return Value(std::move(features));
+}
+
+} // namespace
+
+TEST(ValueCodec, RoundTrip) {
+    for (const Value& value : {Value(), Value(true), Value(uint64_t{42}), Value(int64_t{-42}), Value(0.5),
+                               Value(std::string("foo")), Value(ValueArray{}), makeValue(10)}) {
+        std::string encoded;
+        encodeValue(value, encoded);
+        auto decoded = decodeValue(encoded.data(), encoded.size());
+        ASSERT_TRUE(decoded);
+        EXPECT_TRUE(*decoded == value);
+    }
+}
+
+TEST(ValueCodec, Invalid) {
+    std::string encoded;
+    encodeValue(makeValue(10), encoded);
+    for (std::size_t size : {std::size_t{0}, std::size_t{1}, encoded.size() / 2, encoded.size() - 1}) {
+        auto decoded = decodeValue(encoded.data(), size);
+        ASSERT_FALSE(decoded);
+        EXPECT_EQ(decoded.error(), "Invalid encoded value");
+    }
+    EXPECT_FALSE(decodeValue((encoded + "x").data(), encoded.size() + 1));
+    EXPECT_FALSE(decodeValue("\x08", 1));
+
+    // Deeply nested arrays.
+    std::string nested;
+    for (int i = 0; i < 1000; ++i) {
+        nested += std::string("\x06\x01\x00\x00\x00", 5);
+    }
+    nested += '\0';
+    EXPECT_FALSE(decodeValue(nested.data(), nested.size()));
+}
+
+TEST(ValueCodec, Format) {
+    // Java code decodes the same bytes on every platform.
+    std::string encoded;
+    encodeValue(Value(ValueArray{Value(uint64_t{0x0102}), Value(-1.0), Value(std::string("ab"))}), encoded);
+    EXPECT_EQ(encoded,
+              std::string("\x06\x03\x00\x00\x00"
+                          "\x02\x02\x01\x00\x00\x00\x00\x00\x00"
+                          "\x04\x00\x00\x00\x00\x00\x00\xf0\xbf"
+                          "\x05\x02\x00\x00\x00"
+                          "ab",
+                          30));
+}
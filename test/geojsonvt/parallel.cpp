@@ -0,0 +1,189 @@
+#include "mapbox/geojsonvt/parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+using mapbox::base::ParallelGeoJSONVT;
+using mapbox::base::ParallelGeoJSONVTOptions;
+
+namespace {
+
+mapbox::geojsonvt::feature_collection makePoints(std::size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> lon(-180.0, 180.0);
+    std::uniform_real_distribution<double> lat(-85.0, 85.0);
+
+    mapbox::geojsonvt::feature_collection features;
+    for (std::size_t i = 0; i < count; ++i) {
+        features.emplace_back(mapbox::geometry::point<double>(lon(generator), lat(generator)));
+    }
+    // Points on the antimeridian and on shard boundaries.
+    features.emplace_back(mapbox::geometry::point<double>(180.0, 0.0));
+    features.emplace_back(mapbox::geometry::point<double>(-180.0, 0.0));
+    features.emplace_back(mapbox::geometry::point<double>(0.0, 0.0));
+    return features;
+}
+
+// Lines and polygons spanning several shards at split zoom 2, whose
+// boundaries are the equator, the meridians -90, 0 and 90 and the parallels
+// around 66.5.
+mapbox::geojsonvt::feature_collection makeShapes(std::size_t count) {
+    using namespace mapbox::geometry;
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> lon(-170.0, 170.0);
+    std::uniform_real_distribution<double> lat(-75.0, 75.0);
+    std::uniform_real_distribution<double> span(0.5, 60.0);
+
+    mapbox::geojsonvt::feature_collection features;
+    for (std::size_t i = 0; i < count; ++i) {
+        const double x = lon(generator);
+        const double y = lat(generator);
+        const double dx = span(generator);
+        const double dy = span(generator) / 2;
+        line_string<double> line{{x, y}, {x + dx / 2, y - dy}, {std::min(x + dx, 180.0), std::min(y + dy, 85.0)}};
+        features.emplace_back(line);
+        const double x1 = std::min(x + dx, 180.0);
+        const double y1 = std::min(y + dy, 85.0);
+        features.emplace_back(polygon<double>{{{x, y}, {x1, y}, {x1, y1}, {x, y1}, {x, y}}});
+    }
+    // Shapes along and across the shard boundaries.
+    features.emplace_back(line_string<double>{{-180.0, 0.0}, {180.0, 0.0}});
+    features.emplace_back(line_string<double>{{0.0, -80.0}, {0.0, 80.0}});
+    features.emplace_back(line_string<double>{{-100.0, -70.0}, {100.0, 70.0}});
+    features.emplace_back(polygon<double>{{{-10.0, -10.0}, {10.0, -10.0}, {10.0, 10.0}, {-10.0, 10.0}, {-10.0, -10.0}},
+                                          {{-1.0, -1.0}, {-1.0, 1.0}, {1.0, 1.0}, {1.0, -1.0}, {-1.0, -1.0}}});
+    features.emplace_back(polygon<double>{{{-95.0, 60.0}, {95.0, 60.0}, {95.0, 70.0}, {-95.0, 70.0}, {-95.0, 60.0}}});
+    return features;
+}
+
+void expectSameTiles(mapbox::geojsonvt::GeoJSONVT& reference, ParallelGeoJSONVT& parallel, uint8_t maxZoom) {
+    for (uint8_t z = 0; z <= maxZoom; ++z) {
+        const uint32_t z2 = 1u << z;
+        for (uint32_t y = 0; y < z2; ++y) {
+            for (uint32_t x = 0; x < z2; ++x) {
+                const auto& expected = reference.getTile(z, x, y);
+                const auto& actual = parallel.getTile(z, x, y);
+                EXPECT_EQ(actual.features, expected.features) << int(z) << "/" << x << "/" << y;
+                EXPECT_EQ(actual.num_points, expected.num_points) << int(z) << "/" << x << "/" << y;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(ParallelGeoJSONVT, MatchesGeoJSONVT) {
+    const auto features = makePoints(2000);
+    mapbox::geojsonvt::Options options;
+    options.generateId = true;
+
+    mapbox::geojsonvt::GeoJSONVT reference(features, options);
+    ParallelGeoJSONVTOptions parallelOptions;
+    parallelOptions.splitZoom = 2;
+    parallelOptions.threads = 4;
+    ParallelGeoJSONVT parallel(features, options, parallelOptions);
+
+    for (uint8_t z = 0; z <= 4; ++z) {
+        const uint32_t z2 = 1u << z;
+        for (uint32_t y = 0; y < z2; ++y) {
+            for (uint32_t x = 0; x < z2; ++x) {
+                const auto& expected = reference.getTile(z, x, y);
+                const auto& actual = parallel.getTile(z, x, y);
+                EXPECT_EQ(actual.features, expected.features) << int(z) << "/" << x << "/" << y;
+                EXPECT_EQ(actual.num_points, expected.num_points);
+            }
+        }
+    }
+}
+
+TEST(ParallelGeoJSONVT, MatchesGeoJSONVTLinesPolygons) {
+    const auto features = makeShapes(200);
+    mapbox::geojsonvt::Options options;
+    options.generateId = true;
+    mapbox::geojsonvt::GeoJSONVT reference(features, options);
+
+    for (const uint8_t splitZoom : {1, 2, 3}) {
+        ParallelGeoJSONVTOptions parallelOptions;
+        parallelOptions.splitZoom = splitZoom;
+        parallelOptions.threads = 4;
+        ParallelGeoJSONVT parallel(features, options, parallelOptions);
+        expectSameTiles(reference, parallel, 5);
+    }
+}
+
+TEST(ParallelGeoJSONVT, LargeSplitZoom) {
+    // Split zooms above the supported maximum are clamped instead of
+    // allocating 4^splitZoom shards.
+    const auto features = makeShapes(20);
+    mapbox::geojsonvt::GeoJSONVT reference(features);
+    ParallelGeoJSONVTOptions parallelOptions;
+    parallelOptions.splitZoom = 18;
+    ParallelGeoJSONVT parallel(features, mapbox::geojsonvt::Options(), parallelOptions);
+    expectSameTiles(reference, parallel, 7);
+}
+
+TEST(ParallelGeoJSONVT, Scheduler) {
+    const auto features = makePoints(500);
+    mapbox::geojsonvt::GeoJSONVT reference(features);
+    mapbox::base::Scheduler scheduler(2);
+    ParallelGeoJSONVTOptions parallelOptions;
+    parallelOptions.scheduler = &scheduler;
+    ParallelGeoJSONVT parallel(features, {}, parallelOptions);
+
+    for (uint8_t z = 0; z <= 3; ++z) {
+        const uint32_t z2 = 1u << z;
+        for (uint32_t y = 0; y < z2; ++y) {
+            for (uint32_t x = 0; x < z2; ++x) {
+                EXPECT_EQ(parallel.getTile(z, x, y).features, reference.getTile(z, x, y).features);
+            }
+        }
+    }
+}
+
+TEST(ParallelGeoJSONVT, SingleShard) {
+    const auto features = makePoints(100);
+    mapbox::geojsonvt::GeoJSONVT reference(features);
+    ParallelGeoJSONVTOptions parallelOptions;
+    parallelOptions.splitZoom = 0;
+    ParallelGeoJSONVT parallel(features, mapbox::geojsonvt::Options(), parallelOptions);
+
+    EXPECT_EQ(parallel.getTile(0, 0, 0).features, reference.getTile(0, 0, 0).features);
+    EXPECT_EQ(parallel.getTile(3, 2, 5).features, reference.getTile(3, 2, 5).features);
+}
+
+TEST(ParallelGeoJSONVT, EmptySource) {
+    ParallelGeoJSONVT parallel(mapbox::geojsonvt::feature_collection{});
+    EXPECT_TRUE(parallel.getTile(0, 0, 0).features.empty());
+    EXPECT_TRUE(parallel.getTile(5, 3, 7).features.empty());
+}
+
+TEST(ParallelGeoJSONVT, ConcurrentGetTile) {
+    const auto features = makePoints(2000);
+    mapbox::geojsonvt::GeoJSONVT reference(features);
+    ParallelGeoJSONVT parallel(features);
+
+    constexpr uint8_t z = 6;
+    constexpr uint32_t z2 = 1u << z;
+    std::vector<const ParallelGeoJSONVT::Tile*> tiles(z2 * z2);
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (uint32_t i = t; i < z2 * z2; i += 4) {
+                tiles[i] = &parallel.getTile(z, i % z2, i / z2);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (uint32_t i = 0; i < z2 * z2; ++i) {
+        EXPECT_EQ(tiles[i]->features, reference.getTile(z, i % z2, i / z2).features);
+    }
+}
@@ -0,0 +1,194 @@
+#include "mapbox/geojsonvt/tile_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "mapbox/io/io.hpp"
+#include "test_defines.hpp"
+
+using mapbox::base::TileCache;
+
+namespace {
+
+TileCache::Tile makeTile(int16_t seed) {
+    using namespace mapbox::geometry;
+
+    TileCache::Tile tile;
+    tile.num_points = 42;
+    tile.num_simplified = 7;
+
+    mapbox::feature::feature<int16_t> pointFeature{point<int16_t>(seed, -seed)};
+    pointFeature.id = uint64_t{12};
+    pointFeature.properties["name"] = std::string("point");
+    pointFeature.properties["visible"] = true;
+    pointFeature.properties["rank"] = int64_t{-3};
+    pointFeature.properties["height"] = 12.5;
+    pointFeature.properties["tags"] = mapbox::feature::value::array_type{uint64_t{1}, std::string("two")};
+    pointFeature.properties["nested"] =
+        mapbox::feature::value::object_type{{"key", mapbox::feature::value::array_type{false}}};
+    tile.features.push_back(pointFeature);
+
+    mapbox::feature::feature<int16_t> lineFeature{line_string<int16_t>{{0, 0}, {seed, seed}, {4096, 4096}}};
+    lineFeature.id = std::string("line");
+    tile.features.push_back(lineFeature);
+
+    polygon<int16_t> square{{{0, 0}, {10, 0}, {10, 10}, {0, 10}, {0, 0}}};
+    mapbox::feature::feature<int16_t> polygonFeature{multi_polygon<int16_t>{square, square}};
+    polygonFeature.id = -1.5;
+    tile.features.push_back(polygonFeature);
+
+    return tile;
+}
+
+} // namespace
+
+TEST(TileCache, PutGet) {
+    TileCache cache(std::string(TEST_BINARY_PATH) + "/tile_cache_put_get.bin", 1024 * 1024);
+    const uint64_t source = TileCache::hashSource(R"({"type":"FeatureCollection","features":[]})");
+
+    TileCache::Tile tile;
+    EXPECT_FALSE(cache.get(source, 1, 0, 1, tile));
+
+    cache.put(source, 1, 0, 1, makeTile(5));
+    ASSERT_TRUE(cache.get(source, 1, 0, 1, tile));
+    EXPECT_EQ(tile.features, makeTile(5).features);
+    EXPECT_EQ(tile.num_points, 42u);
+    EXPECT_EQ(tile.num_simplified, 7u);
+
+    EXPECT_FALSE(cache.get(source + 1, 1, 0, 1, tile));
+    EXPECT_FALSE(cache.get(source, 1, 1, 0, tile));
+    EXPECT_EQ(cache.count(), 1u);
+}
+
+TEST(TileCache, Persistence) {
+    const std::string path = std::string(TEST_BINARY_PATH) + "/tile_cache_persistence.bin";
+    const uint64_t source = TileCache::hashSource("source");
+
+    {
+        TileCache cache(path, 1024 * 1024);
+        EXPECT_TRUE(cache.open());
+        cache.put(source, 0, 0, 0, makeTile(1));
+        cache.put(source, 2, 1, 3, makeTile(2));
+        EXPECT_TRUE(cache.flush());
+
+        TileCache::Tile tile;
+        ASSERT_TRUE(cache.get(source, 2, 1, 3, tile));
+        EXPECT_EQ(tile.features, makeTile(2).features);
+    }
+
+    TileCache cache(path, 1024 * 1024);
+    ASSERT_TRUE(cache.open());
+    EXPECT_EQ(cache.count(), 2u);
+
+    TileCache::Tile tile;
+    ASSERT_TRUE(cache.get(source, 0, 0, 0, tile));
+    EXPECT_EQ(tile.features, makeTile(1).features);
+    ASSERT_TRUE(cache.get(source, 2, 1, 3, tile));
+    EXPECT_EQ(tile.features, makeTile(2).features);
+
+    // Mapped and in-memory tiles are written back together.
+    cache.put(source, 3, 0, 0, makeTile(3));
+    EXPECT_TRUE(cache.flush());
+    EXPECT_TRUE(cache.open());
+    EXPECT_EQ(cache.count(), 3u);
+    ASSERT_TRUE(cache.get(source, 3, 0, 0, tile));
+    EXPECT_EQ(tile.features, makeTile(3).features);
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
+
+TEST(TileCache, HashSourceOptions) {
+    const std::string source = R"({"type":"FeatureCollection","features":[]})";
+    mapbox::geojsonvt::Options options;
+    EXPECT_EQ(TileCache::hashSource(source), TileCache::hashSource(source, options));
+
+    options.extent = 8192;
+    EXPECT_NE(TileCache::hashSource(source), TileCache::hashSource(source, options));
+    EXPECT_EQ(TileCache::hashSource(source, options), TileCache::hashSource(source, options));
+
+    mapbox::geojsonvt::Options buffered;
+    buffered.buffer = 128;
+    EXPECT_NE(TileCache::hashSource(source, options), TileCache::hashSource(source, buffered));
+    EXPECT_NE(TileCache::hashSource(source, buffered), TileCache::hashSource("source", buffered));
+}
+
+TEST(TileCache, Eviction) {
+    const uint64_t source = TileCache::hashSource("source");
+
+    TileCache probe(std::string(TEST_BINARY_PATH) + "/tile_cache_probe.bin", 1024 * 1024);
+    probe.put(source, 0, 0, 0, makeTile(0));
+    const std::size_t tileSize = probe.bytes();
+
+    TileCache cache(std::string(TEST_BINARY_PATH) + "/tile_cache_eviction.bin", tileSize * 2);
+    cache.put(source, 1, 0, 0, makeTile(0));
+    cache.put(source, 1, 1, 0, makeTile(0));
+
+    // Touching the first tile makes the second one the least recently used.
+    TileCache::Tile tile;
+    EXPECT_TRUE(cache.get(source, 1, 0, 0, tile));
+    cache.put(source, 1, 0, 1, makeTile(0));
+
+    EXPECT_EQ(cache.count(), 2u);
+    EXPECT_LE(cache.bytes(), tileSize * 2);
+    EXPECT_TRUE(cache.get(source, 1, 0, 0, tile));
+    EXPECT_FALSE(cache.get(source, 1, 1, 0, tile));
+    EXPECT_TRUE(cache.get(source, 1, 0, 1, tile));
+}
+
+TEST(TileCache, GetTile) {
+    TileCache cache(std::string(TEST_BINARY_PATH) + "/tile_cache_get_tile.bin", 1024 * 1024);
+    int calls = 0;
+    const auto makeTileOnce = [&] {
+        ++calls;
+        return makeTile(9);
+    };
+
+    EXPECT_EQ(cache.getTile(1, 4, 2, 2, makeTileOnce).features, makeTile(9).features);
+    EXPECT_EQ(cache.getTile(1, 4, 2, 2, makeTileOnce).features, makeTile(9).features);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(TileCache, InvalidFile) {
+    const std::string path = std::string(TEST_BINARY_PATH) + "/tile_cache_invalid.bin";
+    EXPECT_TRUE(mapbox::base::io::writeFile(path, "not a tile cache"));
+
+    TileCache cache(path, 1024);
+    auto result = cache.open();
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), std::string("Invalid tile cache file '") + path + "'");
+    EXPECT_EQ(cache.count(), 0u);
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
+
+TEST(TileCache, UnreadableFile) {
+    // A cache file that exists but cannot be mapped is an error, so that the
+    // next flush() does not replace it.
+    const std::string directory = std::string(TEST_BINARY_PATH) + "/tile_cache_directory.bin";
+    ::mkdir(directory.c_str(), 0755);
+    TileCache cache(directory, 1024);
+    auto result = cache.open();
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), std::string("Failed to map file '") + directory + "'");
+    ::rmdir(directory.c_str());
+
+    const std::string path = std::string(TEST_BINARY_PATH) + "/tile_cache_unreadable.bin";
+    {
+        TileCache writer(path, 1024 * 1024);
+        writer.put(TileCache::hashSource("source"), 0, 0, 0, makeTile(1));
+        ASSERT_TRUE(writer.flush());
+    }
+    ::chmod(path.c_str(), 0);
+    // Permissions do not apply to root.
+    if (::geteuid() != 0) {
+        TileCache unreadable(path, 1024 * 1024);
+        result = unreadable.open();
+        ASSERT_FALSE(result);
+        EXPECT_EQ(result.error(), std::string("Failed to map file '") + path + "'");
+    }
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
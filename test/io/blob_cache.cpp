@@ -0,0 +1,292 @@
+#include "mapbox/io/blob_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapbox/io/directory.hpp"
+#include "mapbox/io/io.hpp"
+#include "test_defines.hpp"
+
+using namespace mapbox::base;
+
+namespace {
+
+const std::string directory = std::string(TEST_BINARY_PATH) + "/blob_cache";
+
+void deleteCache() {
+    std::vector<std::string> files;
+    io::walkDirectory(directory, [&](const io::DirectoryEntry& entry) { files.push_back(entry.path); });
+    for (const auto& file : files) {
+        std::remove(file.c_str());
+    }
+    std::remove(directory.c_str());
+}
+
+std::string blob(std::size_t size, char seed) {
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<char>(seed + i % 13);
+    }
+    return data;
+}
+
+std::size_t countSegments() {
+    std::size_t count = 0;
+    io::walkDirectory(directory, [&](const io::DirectoryEntry& entry) {
+        if (entry.path.find("/segment-") != std::string::npos) count++;
+    });
+    return count;
+}
+
+} // namespace
+
+TEST(BlobCache, Hash) {
+    EXPECT_EQ(io::BlobKey::hash(""), io::BlobKey::hash(nullptr, 0));
+    EXPECT_EQ(io::BlobKey::hash("foo"), io::BlobKey::hash(std::string("foo")));
+    EXPECT_NE(io::BlobKey::hash("foo"), io::BlobKey::hash("bar"));
+
+    // MurmurHash3_x64_128 reference values, with seed 0.
+    const io::BlobKey empty = io::BlobKey::hash("");
+    EXPECT_EQ(empty.high, 0u);
+    EXPECT_EQ(empty.low, 0u);
+    const io::BlobKey hello = io::BlobKey::hash("hello");
+    EXPECT_EQ(hello.high, 0xcbd8a7b341bd9b02ull);
+    EXPECT_EQ(hello.low, 0x5b1e906a48ae1d19ull);
+}
+
+TEST(BlobCache, PutGetCommit) {
+    deleteCache();
+    io::BlobCacheOptions options;
+    options.segmentSize = 4096;
+
+    std::vector<io::BlobKey> keys;
+    {
+        io::BlobCache cache(directory, options);
+        ASSERT_TRUE(cache.open());
+        EXPECT_EQ(cache.count(), 0u);
+
+        for (int i = 0; i < 20; ++i) {
+            auto key = cache.put(blob(1000, static_cast<char>(i)).data(), 1000);
+            ASSERT_TRUE(key);
+            keys.push_back(*key);
+        }
+        // Content-addressed puts are deduplicated.
+        EXPECT_EQ(*cache.put(blob(1000, 3).data(), 1000), keys[3]);
+        EXPECT_EQ(cache.count(), 20u);
+        EXPECT_EQ(cache.bytes(), 20000u);
+        EXPECT_EQ(cache.diskBytes(), 20000u);
+
+        io::BlobView view;
+        ASSERT_TRUE(cache.get(keys[7], view));
+        EXPECT_EQ(view.str(), blob(1000, 7));
+        EXPECT_FALSE(cache.get(io::BlobKey::hash("missing"), view));
+        EXPECT_EQ(view.str(), blob(1000, 7));
+
+        // Blobs larger than a segment get their own.
+        const std::string large = blob(10000, 'a');
+        ASSERT_TRUE(cache.put(io::BlobKey::hash("large"), large));
+        ASSERT_TRUE(cache.get(io::BlobKey::hash("large"), view));
+        EXPECT_EQ(view.str(), large);
+
+        ASSERT_TRUE(cache.commit());
+
+        // Not committed.
+        ASSERT_TRUE(cache.put(io::BlobKey::hash("lost"), "lost"));
+    }
+
+    {
+        io::BlobCache cache(directory, options);
+        ASSERT_TRUE(cache.open());
+        EXPECT_EQ(cache.count(), 21u);
+        EXPECT_FALSE(cache.contains(io::BlobKey::hash("lost")));
+        io::BlobView view;
+        for (int i = 0; i < 20; ++i) {
+            ASSERT_TRUE(cache.get(keys[i], view));
+            EXPECT_EQ(view.str(), blob(1000, static_cast<char>(i)));
+        }
+
+        // Replacing and removing.
+        ASSERT_TRUE(cache.put(keys[0], "replaced"));
+        ASSERT_TRUE(cache.get(keys[0], view));
+        EXPECT_EQ(view.str(), "replaced");
+        EXPECT_TRUE(cache.remove(keys[1]));
+        EXPECT_FALSE(cache.remove(keys[1]));
+        EXPECT_EQ(cache.count(), 20u);
+        ASSERT_TRUE(cache.commit());
+    }
+
+    // Read-only caches search the mapped index.
+    options.readOnly = true;
+    io::BlobCache reader(directory, options);
+    ASSERT_TRUE(reader.open());
+    EXPECT_EQ(reader.count(), 20u);
+    io::BlobView view;
+    ASSERT_TRUE(reader.get(keys[0], view));
+    EXPECT_EQ(view.str(), "replaced");
+    EXPECT_FALSE(reader.contains(keys[1]));
+    for (int i = 2; i < 20; ++i) {
+        ASSERT_TRUE(reader.get(keys[i], view));
+        EXPECT_EQ(view.str(), blob(1000, static_cast<char>(i)));
+    }
+    EXPECT_FALSE(reader.put(io::BlobKey::hash("foo"), "foo"));
+    EXPECT_FALSE(reader.commit());
+
+    deleteCache();
+}
+
+TEST(BlobCache, Eviction) {
+    deleteCache();
+    io::BlobCacheOptions options;
+    options.segmentSize = 4000;
+    options.maxBytes = 10000;
+
+    io::BlobCache cache(directory, options);
+    ASSERT_TRUE(cache.open());
+
+    std::vector<io::BlobKey> keys;
+    for (int i = 0; i < 10; ++i) {
+        keys.push_back(*cache.put(blob(1000, static_cast<char>(i)).data(), 1000));
+    }
+    // Hold a view to the second blob, and make it the least recently used one.
+    io::BlobView evicted;
+    ASSERT_TRUE(cache.get(keys[1], evicted));
+    io::BlobView view;
+    for (int i : {2, 3, 4, 5, 6, 7, 8, 9, 0}) {
+        ASSERT_TRUE(cache.get(keys[i], view));
+    }
+
+    keys.push_back(*cache.put(blob(1000, 10).data(), 1000));
+    EXPECT_EQ(cache.bytes(), 9000u);
+    EXPECT_TRUE(cache.contains(keys[0]));
+    EXPECT_FALSE(cache.contains(keys[1]));
+    EXPECT_FALSE(cache.contains(keys[2]));
+    EXPECT_TRUE(cache.contains(keys[3]));
+    EXPECT_TRUE(cache.contains(keys[10]));
+    EXPECT_EQ(evicted.str(), blob(1000, 1));
+
+    // Segments less than half full are compacted on commit.
+    for (int i = 3; i < 8; ++i) {
+        EXPECT_TRUE(cache.remove(keys[i]));
+    }
+    const uint64_t before = cache.diskBytes();
+    ASSERT_TRUE(cache.commit());
+    EXPECT_LT(cache.diskBytes(), before);
+    EXPECT_EQ(countSegments(), 1u);
+    EXPECT_EQ(cache.diskBytes(), 4000u);
+    for (const auto& key : {keys[0], keys[8], keys[9], keys[10]}) {
+        ASSERT_TRUE(cache.get(key, view));
+    }
+    ASSERT_TRUE(cache.get(keys[0], view));
+    EXPECT_EQ(view.str(), blob(1000, 0));
+    EXPECT_EQ(evicted.str(), blob(1000, 1));
+
+    deleteCache();
+}
+
+TEST(BlobCache, SingleWriter) {
+    deleteCache();
+    io::BlobCache writer(directory);
+    ASSERT_TRUE(writer.open());
+
+    io::BlobCache other(directory);
+    auto opened = other.open();
+    ASSERT_FALSE(opened);
+    EXPECT_EQ(opened.error(), "Blob cache '" + directory + "' is locked by another writer");
+
+    io::BlobCacheOptions options;
+    options.readOnly = true;
+    io::BlobCache reader(directory, options);
+    EXPECT_TRUE(reader.open());
+
+    deleteCache();
+}
+
+TEST(BlobCache, ConcurrentReaders) {
+    deleteCache();
+    io::BlobCacheOptions options;
+    options.segmentSize = 1 << 16;
+    io::BlobCache cache(directory, options);
+    ASSERT_TRUE(cache.open());
+
+    std::atomic_bool done{false};
+    std::vector<io::BlobKey> keys(1000);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = io::BlobKey::hash(std::to_string(i));
+    }
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            io::BlobView view;
+            while (!done) {
+                for (std::size_t i = 0; i < keys.size(); ++i) {
+                    if (cache.get(keys[i], view)) {
+                        EXPECT_EQ(view.str(), blob(100 + i % 50, static_cast<char>(i)));
+                    }
+                }
+            }
+        });
+    }
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_TRUE(cache.put(keys[i], blob(100 + i % 50, static_cast<char>(i))));
+        if (i % 100 == 0) {
+            ASSERT_TRUE(cache.commit());
+        }
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(cache.count(), keys.size());
+
+    deleteCache();
+}
+
+TEST(BlobCache, InvalidIndex) {
+    deleteCache();
+    {
+        io::BlobCache cache(directory);
+        ASSERT_TRUE(cache.open());
+    }
+    ASSERT_TRUE(io::writeFile(directory + "/index", "not an index"));
+    io::BlobCache cache(directory);
+    auto opened = cache.open();
+    ASSERT_FALSE(opened);
+    EXPECT_EQ(opened.error(), "Invalid blob cache index '" + directory + "/index'");
+
+    deleteCache();
+}
+
+TEST(BlobCache, TemporaryIndex) {
+    deleteCache();
+    const auto countTemporary = [] {
+        std::size_t count = 0;
+        io::walkDirectory(directory, [&](const io::DirectoryEntry& entry) {
+            if (entry.path.find("/index.") != std::string::npos) count++;
+        });
+        return count;
+    };
+
+    {
+        io::BlobCache cache(directory);
+        ASSERT_TRUE(cache.open());
+        ASSERT_TRUE(cache.put(io::BlobKey::hash("foo"), "foo"));
+        ASSERT_TRUE(cache.commit());
+        EXPECT_EQ(countTemporary(), 0u);
+    }
+
+    // Left behind by a crash during a commit.
+    ASSERT_TRUE(io::writeFile(directory + "/index.a1B2c3", "partial"));
+    EXPECT_EQ(countTemporary(), 1u);
+    io::BlobCache cache(directory);
+    ASSERT_TRUE(cache.open());
+    EXPECT_EQ(countTemporary(), 0u);
+    EXPECT_TRUE(cache.contains(io::BlobKey::hash("foo")));
+
+    deleteCache();
+}
@@ -0,0 +1,171 @@
+#include "mapbox/io/compressed.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "mapbox/io/io.hpp"
+#include "mapbox/util/scheduler.hpp"
+#include "test_defines.hpp"
+
+using namespace mapbox::base;
+
+namespace {
+
+const std::string path = std::string(TEST_BINARY_PATH) + "/compressed.bin";
+
+// Compressible data with some variation.
+std::string makeData(std::size_t size) {
+    std::string data;
+    data.reserve(size);
+    uint32_t state = 1;
+    while (data.size() < size) {
+        state = state * 1103515245u + 12345u;
+        data += "{\"tile\":" + std::to_string(state % 1000) + ",\"features\":[]}";
+    }
+    data.resize(size);
+    return data;
+}
+
+} // namespace
+
+TEST(Compressed, DetectCodec) {
+    EXPECT_EQ(io::detectCodec("\x28\xb5\x2f\xfd\x00", 5), io::Codec::Zstd);
+    EXPECT_EQ(io::detectCodec("\x1f\x8b\x08", 3), io::Codec::Deflate);
+    // zlib headers, and plain text that would pass the zlib header check.
+    EXPECT_EQ(io::detectCodec("\x78\x9c", 2), io::Codec::None);
+    for (const char* text : {"80", "8O", "(S", "HK", "Xf", "hb"}) {
+        EXPECT_EQ(io::detectCodec(text, 2), io::Codec::None);
+    }
+    EXPECT_EQ(io::detectCodec("{}", 2), io::Codec::None);
+    EXPECT_EQ(io::detectCodec("", 0), io::Codec::None);
+}
+
+TEST(Compressed, Uncompressed) {
+    io::CompressionOptions options;
+    options.codec = io::Codec::None;
+    const std::string data = makeData(1000);
+    ASSERT_TRUE(io::writeCompressedFile(path, data, options));
+    EXPECT_EQ(*io::readFile(path), data);
+    EXPECT_EQ(*io::readCompressedFile(path), data);
+
+    ASSERT_TRUE(io::writeFile(path, ""));
+    EXPECT_EQ(*io::readCompressedFile(path), "");
+
+    ASSERT_TRUE(io::writeFile(path, "80 km/h"));
+    EXPECT_EQ(*io::readCompressedFile(path), "80 km/h");
+
+    auto result = io::readCompressedFile("invalid");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), "Failed to read file 'invalid'");
+    EXPECT_TRUE(io::deleteFile(path));
+}
+
+#if MB_IO_ZLIB
+TEST(Compressed, Deflate) {
+    io::CompressionOptions options;
+    options.codec = io::Codec::Deflate;
+    for (std::size_t size : {0u, 1u, 1000u, 5000000u}) {
+        const std::string data = makeData(size);
+        ASSERT_TRUE(io::writeCompressedFile(path, data, options));
+        const std::string compressed = *io::readFile(path);
+        EXPECT_EQ(io::detectCodec(compressed.data(), compressed.size()), io::Codec::Deflate);
+        if (size > 1000) {
+            EXPECT_LT(compressed.size(), size / 4);
+        }
+        EXPECT_TRUE(*io::readCompressedFile(path) == data);
+    }
+
+    // Concatenated gzip members.
+    const std::string data = makeData(100000);
+    ASSERT_TRUE(io::writeCompressedFile(path, data, options));
+    const std::string member = *io::readFile(path);
+    ASSERT_TRUE(io::writeFile(path, member + member));
+    EXPECT_TRUE(*io::readCompressedFile(path) == data + data);
+
+    // Truncated and corrupted streams.
+    ASSERT_TRUE(io::writeFile(path, member.substr(0, member.size() / 2)));
+    auto result = io::readCompressedFile(path);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), "Failed to decompress file '" + path + "'");
+    std::string corrupted = member;
+    corrupted[member.size() / 2] ^= 0x55;
+    ASSERT_TRUE(io::writeFile(path, corrupted));
+    EXPECT_FALSE(io::readCompressedFile(path));
+
+    EXPECT_TRUE(io::deleteFile(path));
+}
+
+TEST(Compressed, ParallelDeflate) {
+    Scheduler scheduler(4);
+    io::CompressionOptions options;
+    options.codec = io::Codec::Deflate;
+    options.threads = 4;
+    options.scheduler = &scheduler;
+
+    for (std::size_t size : {(1u << 20) + 1, 5000000u}) {
+        const std::string data = makeData(size);
+        ASSERT_TRUE(io::writeCompressedFile(path, data, options));
+        const std::string compressed = *io::readFile(path);
+        EXPECT_LT(compressed.size(), size / 4);
+
+        // The stream is a regular gzip stream.
+        z_stream stream{};
+        ASSERT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+        std::string out(size, '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+        stream.avail_in = static_cast<uInt>(compressed.size());
+        stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+        stream.avail_out = static_cast<uInt>(out.size());
+        EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+        EXPECT_EQ(stream.avail_in, 0u);
+        inflateEnd(&stream);
+        EXPECT_TRUE(out == data);
+
+        EXPECT_TRUE(*io::readCompressedFile(path) == data);
+    }
+
+    // The output does not depend on the number of threads, including when
+    // fewer threads are used than the scheduler has workers.
+    Scheduler wide(8);
+    options.scheduler = &wide;
+    const std::string data = makeData(5000000u);
+    ASSERT_TRUE(io::writeCompressedFile(path, data, options));
+    const std::string expected = *io::readFile(path);
+    for (std::size_t threads : {2u, 3u, 16u}) {
+        options.threads = threads;
+        ASSERT_TRUE(io::writeCompressedFile(path, data, options));
+        EXPECT_TRUE(*io::readFile(path) == expected);
+    }
+
+    EXPECT_TRUE(io::deleteFile(path));
+}
+#endif
+
+#if MB_IO_ZSTD
+TEST(Compressed, Zstd) {
+    io::CompressionOptions options;
+    options.codec = io::Codec::Zstd;
+    for (std::size_t threads : {1u, 4u}) {
+        options.threads = threads;
+        for (std::size_t size : {0u, 1000u, 5000000u}) {
+            const std::string data = makeData(size);
+            ASSERT_TRUE(io::writeCompressedFile(path, data, options));
+            const std::string compressed = *io::readFile(path);
+            EXPECT_EQ(io::detectCodec(compressed.data(), compressed.size()), io::Codec::Zstd);
+            EXPECT_TRUE(*io::readCompressedFile(path) == data);
+        }
+    }
+    EXPECT_TRUE(io::deleteFile(path));
+}
+#endif
+
+#if !MB_IO_ZLIB || !MB_IO_ZSTD
+TEST(Compressed, DisabledCodec) {
+    io::CompressionOptions options;
+    options.codec = MB_IO_ZLIB ? io::Codec::Zstd : io::Codec::Deflate;
+    auto result = io::writeCompressedFile(path, "foo", options);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), "Failed to compress file '" + path + "'");
+}
+#endif
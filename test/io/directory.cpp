@@ -0,0 +1,176 @@
+#include "mapbox/io/directory.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "mapbox/io/io.hpp"
+#include "mapbox/util/scheduler.hpp"
+#include "test_defines.hpp"
+
+using namespace mapbox::base;
+
+namespace {
+
+const std::string root = std::string(TEST_BINARY_PATH) + "/walk";
+
+// Creates `root` with 3 levels of 4 subdirectories, each with 5 files.
+std::map<std::string, uint64_t> createTree() {
+    std::map<std::string, uint64_t> files;
+    ::mkdir(root.c_str(), 0755);
+    std::vector<std::string> level{root};
+    for (int depth = 0; depth < 3; ++depth) {
+        std::vector<std::string> next;
+        for (const auto& directory : level) {
+            for (int i = 0; i < 5; ++i) {
+                const std::string path = directory + "/file" + std::to_string(i) + ".bin";
+                const std::string contents(static_cast<std::size_t>(depth * 100 + i), 'x');
+                EXPECT_TRUE(io::writeFile(path, contents));
+                files[path] = contents.size();
+            }
+            for (int i = 0; i < 4; ++i) {
+                const std::string path = directory + "/dir" + std::to_string(i);
+                ::mkdir(path.c_str(), 0755);
+                files[path] = 0;
+                next.push_back(path);
+            }
+        }
+        level = std::move(next);
+    }
+    return files;
+}
+
+void deleteTree(const std::map<std::string, uint64_t>& files) {
+    for (auto it = files.rbegin(); it != files.rend(); ++it) {
+        ::remove(it->first.c_str());
+    }
+    ::rmdir(root.c_str());
+}
+
+} // namespace
+
+TEST(io, WalkDirectory) {
+    const auto files = createTree();
+    const auto start = std::chrono::system_clock::now() - std::chrono::hours(1);
+
+    std::map<std::string, uint64_t> found;
+    auto result = io::walkDirectory(root, [&](const io::DirectoryEntry& entry) {
+        EXPECT_TRUE(found.emplace(entry.path, entry.size).second);
+        EXPECT_GT(entry.modified, start);
+        const bool isDirectory = entry.path.find("/file") == std::string::npos;
+        EXPECT_EQ(entry.type, isDirectory ? io::EntryType::Directory : io::EntryType::File);
+    });
+    EXPECT_TRUE(result);
+    for (auto& file : found) {
+        if (file.first.find("/file") == std::string::npos) file.second = 0;
+    }
+    EXPECT_EQ(found, files);
+
+    // Not recursive, without stats.
+    std::size_t count = 0;
+    io::WalkOptions options;
+    options.recursive = false;
+    options.stat = false;
+    result = io::walkDirectory(
+        root + "/",
+        [&](const io::DirectoryEntry& entry) {
+            EXPECT_EQ(entry.path.find(root + "/"), 0u);
+            EXPECT_EQ(entry.path.find('/', root.size() + 1), std::string::npos);
+            EXPECT_EQ(entry.size, 0u);
+            count++;
+        },
+        options);
+    EXPECT_TRUE(result);
+    EXPECT_EQ(count, 9u);
+
+    deleteTree(files);
+}
+
+TEST(io, WalkDirectoryParallel) {
+    const auto files = createTree();
+    Scheduler scheduler(4);
+    io::WalkOptions options;
+    options.scheduler = &scheduler;
+
+    std::mutex mutex;
+    std::map<std::string, uint64_t> found;
+    auto result = io::walkDirectory(
+        root,
+        [&](const io::DirectoryEntry& entry) {
+            std::lock_guard<std::mutex> lock(mutex);
+            EXPECT_TRUE(found.emplace(entry.path, entry.type == io::EntryType::File ? entry.size : 0).second);
+        },
+        options);
+    EXPECT_TRUE(result);
+    EXPECT_EQ(found, files);
+
+    // Exceptions thrown by the callback stop the walk.
+    std::atomic_size_t calls{0u};
+    EXPECT_THROW(io::walkDirectory(
+                     root,
+                     [&](const io::DirectoryEntry& entry) {
+                         calls++;
+                         if (entry.path.find("dir2/dir1/file3") != std::string::npos) {
+                             throw std::runtime_error("stop");
+                         }
+                     },
+                     options),
+                 std::runtime_error);
+    EXPECT_LE(calls, files.size());
+
+    deleteTree(files);
+}
+
+TEST(io, WalkDirectoryErrors) {
+    auto result = io::walkDirectory("invalid", [](const io::DirectoryEntry&) { FAIL(); });
+    EXPECT_FALSE(result);
+    EXPECT_EQ(result.error(), std::string("Failed to read directory 'invalid'"));
+
+    const std::string file = std::string(TEST_BINARY_PATH) + "/walk_file.txt";
+    ASSERT_TRUE(io::writeFile(file, "foo"));
+    result = io::walkDirectory(file, [](const io::DirectoryEntry&) { FAIL(); });
+    EXPECT_FALSE(result);
+    EXPECT_TRUE(io::deleteFile(file));
+}
+
+TEST(io, WalkDirectoryConcurrentRemoval) {
+    const std::string directory = std::string(TEST_BINARY_PATH) + "/walk_removal";
+    ::mkdir(directory.c_str(), 0755);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(io::writeFile(directory + "/file" + std::to_string(i) + ".bin", "x"));
+    }
+    for (int i = 0; i < 10; ++i) {
+        ::mkdir((directory + "/dir" + std::to_string(i)).c_str(), 0755);
+    }
+
+    // The first entry removes all the others, which the directory listing
+    // may still report.
+    std::size_t calls = 0;
+    auto result = io::walkDirectory(directory, [&](const io::DirectoryEntry& entry) {
+        if (calls++ > 0) return;
+        for (int i = 0; i < 100; ++i) {
+            const std::string path = directory + "/file" + std::to_string(i) + ".bin";
+            if (path != entry.path) ::remove(path.c_str());
+        }
+        for (int i = 0; i < 10; ++i) {
+            const std::string path = directory + "/dir" + std::to_string(i);
+            if (path != entry.path) ::rmdir(path.c_str());
+        }
+    });
+    EXPECT_TRUE(result);
+    EXPECT_GE(calls, 1u);
+
+    for (int i = 0; i < 100; ++i) {
+        ::remove((directory + "/file" + std::to_string(i) + ".bin").c_str());
+    }
+    for (int i = 0; i < 10; ++i) {
+        ::rmdir((directory + "/dir" + std::to_string(i)).c_str());
+    }
+    ::rmdir(directory.c_str());
+}
@@ -2,13 +2,23 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "io_delete.hpp"
 #include "mapbox/util/expected.hpp"
+#include "mapbox/util/memory.hpp"
 #include "test_defines.hpp"
 
+#if !MB_PLATFORM_IS_WIN32
+#    include <dirent.h>
+#    include <sys/stat.h>
+#endif
+
 TEST(io, ReadWriteFiles) {
     const std::string path(std::string(TEST_BINARY_PATH) + "/foo.txt");
     const std::string copyPath(std::string(TEST_BINARY_PATH) + "/bar.txt");
@@ -47,3 +57,164 @@ TEST(io, ReadWriteFiles) {
 
     deleteTests(path, copyPath, invalidPath);
 }
+
+TEST(io, ReadFileWithAllocator) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/allocator.txt");
+    const std::string contents(10000, 'x');
+    ASSERT_TRUE(mapbox::base::io::writeFile(path, contents));
+
+    mapbox::base::MonotonicBufferResource arena;
+    mapbox::base::PolymorphicAllocator<char> allocator(&arena);
+    auto result = mapbox::base::io::readFile(path, allocator);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->size(), contents.size());
+    EXPECT_EQ(std::string(result->data(), result->size()), contents);
+    EXPECT_EQ(result->get_allocator().resource(), &arena);
+
+    auto invalid = mapbox::base::io::readFile("invalid", allocator);
+    EXPECT_FALSE(invalid);
+    EXPECT_EQ(invalid.error(), std::string("Failed to read file 'invalid'"));
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
+
+TEST(io, LargeAndEmptyFiles) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/large.bin");
+    const std::string copyPath(std::string(TEST_BINARY_PATH) + "/large_copy.bin");
+
+    std::string large(3 * 1024 * 1024 + 17, '\0');
+    for (std::size_t i = 0; i < large.size(); ++i) {
+        large[i] = static_cast<char>(i * 31 % 251);
+    }
+    ASSERT_TRUE(mapbox::base::io::writeFile(path, large));
+    auto contents = mapbox::base::io::readFile(path);
+    ASSERT_TRUE(contents);
+    EXPECT_TRUE(*contents == large);
+
+    ASSERT_TRUE(mapbox::base::io::copyFile(path, copyPath));
+    contents = mapbox::base::io::readFile(copyPath);
+    ASSERT_TRUE(contents);
+    EXPECT_TRUE(*contents == large);
+
+    // Overwriting truncates.
+    ASSERT_TRUE(mapbox::base::io::writeFile(path, std::string()));
+    contents = mapbox::base::io::readFile(path);
+    ASSERT_TRUE(contents);
+    EXPECT_TRUE(contents->empty());
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+    EXPECT_TRUE(mapbox::base::io::deleteFile(copyPath));
+}
+
+TEST(io, CopyFileOntoItself) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/self.txt");
+    const std::string copyPath(std::string(TEST_BINARY_PATH) + "/self_copy.txt");
+
+    ASSERT_TRUE(mapbox::base::io::writeFile(path, "Hello, World!"));
+    ASSERT_TRUE(mapbox::base::io::copyFile(path, path));
+    EXPECT_EQ(*mapbox::base::io::readFile(path), "Hello, World!");
+
+    // Copying over a longer file truncates it.
+    ASSERT_TRUE(mapbox::base::io::writeFile(copyPath, "A much longer destination file"));
+    ASSERT_TRUE(mapbox::base::io::copyFile(path, copyPath));
+    EXPECT_EQ(*mapbox::base::io::readFile(copyPath), "Hello, World!");
+    EXPECT_TRUE(mapbox::base::io::deleteFile(copyPath));
+
+#if !MB_PLATFORM_IS_WIN32
+    // Hard and symbolic links to the source.
+    ASSERT_EQ(::link(path.c_str(), copyPath.c_str()), 0);
+    ASSERT_TRUE(mapbox::base::io::copyFile(path, copyPath));
+    EXPECT_EQ(*mapbox::base::io::readFile(path), "Hello, World!");
+    EXPECT_TRUE(mapbox::base::io::deleteFile(copyPath));
+
+    ASSERT_EQ(::symlink(path.c_str(), copyPath.c_str()), 0);
+    ASSERT_TRUE(mapbox::base::io::copyFile(path, copyPath));
+    EXPECT_EQ(*mapbox::base::io::readFile(path), "Hello, World!");
+    EXPECT_TRUE(mapbox::base::io::deleteFile(copyPath));
+#endif
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
+
+TEST(io, WriteFileAtomic) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/atomic.txt");
+
+    ASSERT_TRUE(mapbox::base::io::writeFileAtomic(path, "first"));
+    EXPECT_EQ(*mapbox::base::io::readFile(path), "first");
+
+    // Streamed in pieces larger and smaller than the writer buffer.
+    std::string expected;
+    ASSERT_TRUE(mapbox::base::io::writeFileAtomic(path, [&](mapbox::base::io::FileWriter& writer) {
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const std::string piece(i % 7 == 0 ? 40000 : i % 13, static_cast<char>('a' + i % 26));
+            expected += piece;
+            if (!writer.write(piece.data(), piece.size())) return false;
+        }
+        return writer.offset() == expected.size();
+    }));
+    EXPECT_TRUE(*mapbox::base::io::readFile(path) == expected);
+
+    // A failed write keeps the previous contents.
+    auto result = mapbox::base::io::writeFileAtomic(path, [](mapbox::base::io::FileWriter& writer) {
+        return writer.write("partial", 7) && false;
+    });
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), "Failed to write file '" + path + "'");
+    EXPECT_TRUE(*mapbox::base::io::readFile(path) == expected);
+
+    EXPECT_FALSE(mapbox::base::io::writeFileAtomic(std::string(TEST_BINARY_PATH) + "/missing/atomic.txt", "data"));
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
+
+#if !MB_PLATFORM_IS_WIN32
+TEST(io, WriteFileAtomicConcurrent) {
+    const std::string directory(std::string(TEST_BINARY_PATH) + "/atomic");
+    const std::string path(directory + "/file.txt");
+    ::mkdir(directory.c_str(), 0755);
+
+    // Writers replacing the same file do not share a temporary file, so the
+    // file always holds the whole contents of one of them.
+    std::vector<std::string> contents;
+    for (char c = 'a'; c < 'i'; ++c) {
+        contents.emplace_back(200000, c);
+    }
+    std::atomic_size_t failures{0u};
+    std::vector<std::thread> writers;
+    for (const auto& data : contents) {
+        writers.emplace_back([&] {
+            for (int i = 0; i < 10; ++i) {
+                if (!mapbox::base::io::writeFileAtomic(path, data)) failures++;
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    EXPECT_EQ(failures, 0u);
+    const auto result = mapbox::base::io::readFile(path);
+    ASSERT_TRUE(result);
+    EXPECT_NE(std::find(contents.begin(), contents.end(), *result), contents.end());
+
+    // A failed write removes its temporary file.
+    EXPECT_FALSE(mapbox::base::io::writeFileAtomic(path, [](mapbox::base::io::FileWriter&) { return false; }));
+    std::vector<std::string> files;
+    DIR* dir = ::opendir(directory.c_str());
+    ASSERT_TRUE(dir);
+    while (const dirent* entry = ::readdir(dir)) {
+        if (entry->d_name[0] != '.') files.emplace_back(entry->d_name);
+    }
+    ::closedir(dir);
+    EXPECT_EQ(files, std::vector<std::string>{"file.txt"});
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+    ::rmdir(directory.c_str());
+}
+#endif
+
+#if !MB_IO_USE_IOSTREAM
+TEST(io, ReadDirectory) {
+    auto contents = mapbox::base::io::readFile(TEST_BINARY_PATH);
+    EXPECT_FALSE(contents);
+    EXPECT_EQ(contents.error(), std::string("Failed to read file '") + TEST_BINARY_PATH + "'");
+}
+#endif
@@ -0,0 +1,37 @@
+#include "mapbox/io/mapped_file.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+#include "mapbox/io/io.hpp"
+#include "test_defines.hpp"
+
+using mapbox::base::io::MappedFile;
+
+TEST(io, MappedFile) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/mapped.txt");
+    const std::string contents("mapped contents");
+    EXPECT_TRUE(mapbox::base::io::writeFile(path, contents));
+
+    auto mapped = MappedFile::open(path);
+    ASSERT_TRUE(mapped);
+    EXPECT_EQ(std::string(mapped->data(), mapped->size()), contents);
+
+    MappedFile moved = std::move(*mapped);
+    EXPECT_EQ(std::string(moved.data(), moved.size()), contents);
+    EXPECT_EQ(mapped->data(), nullptr);
+    EXPECT_TRUE(mapped->empty());
+
+    EXPECT_TRUE(mapbox::base::io::writeFile(path, ""));
+    auto empty = MappedFile::open(path);
+    ASSERT_TRUE(empty);
+    EXPECT_TRUE(empty->empty());
+
+    auto invalid = MappedFile::open("invalid");
+    EXPECT_FALSE(invalid);
+    EXPECT_EQ(invalid.error(), std::string("Failed to map file 'invalid'"));
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
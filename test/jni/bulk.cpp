@@ -0,0 +1,158 @@
+#include "mapbox/jni/bulk.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "mapbox/compatibility/value_codec.hpp"
+#include "mock_env.hpp"
+
+using namespace mapbox::base;
+
+namespace {
+
+Value makeValue(std::size_t count) {
+    ValueArray features;
+    for (std::size_t i = 0; i < count; ++i) {
+        ValueObject properties;
+        properties["id"] = Value(uint64_t{i});
+        properties["name"] = Value(std::string("feature ") + std::to_string(i));
+        properties["height"] = Value(static_cast<double>(i) / 4);
+        properties["offset"] = Value(-static_cast<int64_t>(i));
+        properties["visible"] = Value(i % 2 == 0);
+        properties["tags"] = Value(ValueArray{Value(std::string("a")), Value(), Value(ValueObject{})});
+        features.emplace_back(std::move(properties));
+    }
+    return Value(std::move(features));
+}
+
+// The bytes `ValueCodec.encode()` writes for `value`.
+std::string encodeForJava(const Value& value) {
+    std::string encoded(1, static_cast<char>(kValueFormatVersion));
+    encodeValue(value, encoded);
+    return encoded;
+}
+
+std::string bytes(const MockJNIEnv::Object& object) {
+    return std::string(object.bytes.data(), object.bytes.size());
+}
+
+} // namespace
+
+TEST(JNIBulk, DirectByteBuffer) {
+    MockJNIEnv mock;
+    std::string data = "hello world";
+
+    {
+        auto buffer = newDirectByteBuffer(mock.env(), &data[0], data.size());
+        const auto& object = MockJNIEnv::object(buffer.get());
+        EXPECT_TRUE(object.direct);
+        EXPECT_FALSE(object.readOnly);
+        EXPECT_EQ(object.address, data.data());
+        EXPECT_EQ(object.capacity, data.size());
+        EXPECT_EQ(mock.localRefs, 1u);
+
+        auto direct = getDirectBuffer(mock.env(), buffer);
+        ASSERT_TRUE(direct);
+        EXPECT_EQ(direct->data, data.data());
+        EXPECT_EQ(direct->size, data.size());
+
+        auto heap = getDirectBuffer(mock.env(), mock.newHeapByteBuffer(16));
+        ASSERT_FALSE(heap);
+        EXPECT_EQ(heap.error(), "ByteBuffer is not direct");
+    }
+    EXPECT_EQ(mock.localRefs, 0u);
+
+    // Sizes a ByteBuffer cannot hold raise a Java exception.
+    EXPECT_THROW(newDirectByteBuffer(mock.env(), &data[0], std::size_t{1} << 31), jni::PendingJavaException);
+    EXPECT_TRUE(mock.exceptionPending);
+    EXPECT_EQ(mock.exceptionType, "java/lang/IllegalArgumentException");
+    EXPECT_EQ(mock.exceptionMessage, "Buffer is too large for a ByteBuffer");
+}
+
+TEST(JNIBulk, ReadOnlyByteBuffer) {
+    MockJNIEnv mock;
+    const std::string data = "hello world";
+
+    auto buffer = newReadOnlyByteBuffer(mock.env(), data);
+    const auto& object = MockJNIEnv::object(buffer.get());
+    EXPECT_TRUE(object.direct);
+    EXPECT_TRUE(object.readOnly);
+    EXPECT_EQ(object.address, data.data());
+    EXPECT_EQ(object.capacity, data.size());
+    // Only the returned reference is left.
+    EXPECT_EQ(mock.localRefs, 1u);
+
+    // The method lookup is cached.
+    const std::size_t calls = mock.calls;
+    auto prefix = newReadOnlyByteBuffer(mock.env(), data.data(), 5);
+    EXPECT_EQ(MockJNIEnv::object(prefix.get()).capacity, 5u);
+    EXPECT_LE(mock.calls - calls, 5u);
+    EXPECT_EQ(mock.localRefs, 2u);
+}
+
+TEST(JNIBulk, ValueToByteArray) {
+    MockJNIEnv mock;
+    const Value value = makeValue(10000);
+
+    // The number of JNI calls does not depend on the value size.
+    const auto calls = [&](const Value& converted) {
+        const std::size_t before = mock.calls;
+        valueToByteArray(mock.env(), converted);
+        return mock.calls - before;
+    };
+    EXPECT_EQ(calls(value), calls(makeValue(1)));
+
+    auto array = valueToByteArray(mock.env(), value);
+    EXPECT_EQ(mock.localRefs, 1u);
+
+    EXPECT_TRUE(bytes(MockJNIEnv::object(array.get())) == encodeForJava(value));
+
+    mock.maxArraySize = 16;
+    EXPECT_THROW(valueToByteArray(mock.env(), value), jni::PendingJavaException);
+    EXPECT_TRUE(mock.exceptionPending);
+    EXPECT_EQ(mock.localRefs, 1u);
+}
+
+TEST(JNIBulk, ValueToByteBuffer) {
+    MockJNIEnv mock;
+    const Value value = makeValue(100);
+
+    std::string storage;
+    auto buffer = valueToByteBuffer(mock.env(), value, storage);
+    const auto& object = MockJNIEnv::object(buffer.get());
+    EXPECT_TRUE(object.readOnly);
+    EXPECT_EQ(object.address, storage.data());
+    EXPECT_EQ(object.capacity, storage.size());
+    EXPECT_EQ(storage, encodeForJava(value));
+
+    auto decoded = valueFromByteBuffer(mock.env(), buffer);
+    ASSERT_TRUE(decoded);
+    EXPECT_TRUE(*decoded == value);
+
+    auto heap = valueFromByteBuffer(mock.env(), mock.newHeapByteBuffer(16));
+    ASSERT_FALSE(heap);
+    EXPECT_EQ(heap.error(), "ByteBuffer is not direct");
+}
+
+TEST(JNIBulk, ValueFromByteArray) {
+    MockJNIEnv mock;
+    const Value value = makeValue(100);
+    const std::string encoded = encodeForJava(value);
+
+    auto decoded = valueFromByteArray(mock.env(), mock.newByteArray(encoded));
+    ASSERT_TRUE(decoded);
+    EXPECT_TRUE(*decoded == value);
+
+    auto invalid = valueFromByteArray(mock.env(), mock.newByteArray(encoded.substr(0, encoded.size() / 2)));
+    ASSERT_FALSE(invalid);
+    EXPECT_EQ(invalid.error(), "Invalid encoded value");
+    EXPECT_FALSE(valueFromByteArray(mock.env(), mock.newByteArray("")));
+
+    std::string future = encoded;
+    future[0] = static_cast<char>(kValueFormatVersion + 1);
+    auto unsupported = valueFromByteArray(mock.env(), mock.newByteArray(future));
+    ASSERT_FALSE(unsupported);
+    EXPECT_EQ(unsupported.error(), "Unsupported encoded value version");
+    EXPECT_EQ(mock.localRefs, 0u);
+}
@@ -0,0 +1,1062 @@
+#pragma once
+
+// <jni.h> for the JNI tests, so that they build without a JDK. Types, the
+// function table layout and the function signatures follow the JNI
+// specification (JNI 9); the mock environment fills the entries it
+// implements.
+
+#include <cstdarg>
+#include <cstdint>
+
+#define JNIEXPORT __attribute__((visibility("default")))
+#define JNIIMPORT
+#define JNICALL
+
+typedef uint8_t jboolean;
+typedef int8_t jbyte;
+typedef uint16_t jchar;
+typedef int16_t jshort;
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef float jfloat;
+typedef double jdouble;
+typedef jint jsize;
+
+class _jobject {};
+class _jclass : public _jobject {};
+class _jthrowable : public _jobject {};
+class _jstring : public _jobject {};
+class _jarray : public _jobject {};
+class _jbooleanArray : public _jarray {};
+class _jbyteArray : public _jarray {};
+class _jcharArray : public _jarray {};
+class _jshortArray : public _jarray {};
+class _jintArray : public _jarray {};
+class _jlongArray : public _jarray {};
+class _jfloatArray : public _jarray {};
+class _jdoubleArray : public _jarray {};
+class _jobjectArray : public _jarray {};
+
+typedef _jobject* jobject;
+typedef _jclass* jclass;
+typedef _jthrowable* jthrowable;
+typedef _jstring* jstring;
+typedef _jarray* jarray;
+typedef _jbooleanArray* jbooleanArray;
+typedef _jbyteArray* jbyteArray;
+typedef _jcharArray* jcharArray;
+typedef _jshortArray* jshortArray;
+typedef _jintArray* jintArray;
+typedef _jlongArray* jlongArray;
+typedef _jfloatArray* jfloatArray;
+typedef _jdoubleArray* jdoubleArray;
+typedef _jobjectArray* jobjectArray;
+typedef jobject jweak;
+
+typedef union jvalue {
+    jboolean z;
+    jbyte b;
+    jchar c;
+    jshort s;
+    jint i;
+    jlong j;
+    jfloat f;
+    jdouble d;
+    jobject l;
+} jvalue;
+
+struct _jfieldID;
+typedef struct _jfieldID* jfieldID;
+struct _jmethodID;
+typedef struct _jmethodID* jmethodID;
+
+typedef enum _jobjectType {
+    JNIInvalidRefType = 0,
+    JNILocalRefType = 1,
+    JNIGlobalRefType = 2,
+    JNIWeakGlobalRefType = 3
+} jobjectRefType;
+
+typedef struct {
+    char* name;
+    char* signature;
+    void* fnPtr;
+} JNINativeMethod;
+
+#define JNI_FALSE 0
+#define JNI_TRUE 1
+
+#define JNI_OK 0
+#define JNI_ERR (-1)
+#define JNI_EDETACHED (-2)
+#define JNI_EVERSION (-3)
+#define JNI_ENOMEM (-4)
+#define JNI_EEXIST (-5)
+#define JNI_EINVAL (-6)
+
+#define JNI_COMMIT 1
+#define JNI_ABORT 2
+
+#define JNI_VERSION_1_1 0x00010001
+#define JNI_VERSION_1_2 0x00010002
+#define JNI_VERSION_1_4 0x00010004
+#define JNI_VERSION_1_6 0x00010006
+#define JNI_VERSION_1_8 0x00010008
+#define JNI_VERSION_9 0x00090000
+
+struct JNIEnv_;
+struct JavaVM_;
+typedef JNIEnv_ JNIEnv;
+typedef JavaVM_ JavaVM;
+
+struct JNINativeInterface_ {
+    void* reserved0;
+    void* reserved1;
+    void* reserved2;
+    void* reserved3;
+    jint(JNICALL* GetVersion)(JNIEnv*);
+    jclass(JNICALL* DefineClass)(JNIEnv*, const char*, jobject, const jbyte*, jsize);
+    jclass(JNICALL* FindClass)(JNIEnv*, const char*);
+    jmethodID(JNICALL* FromReflectedMethod)(JNIEnv*, jobject);
+    jfieldID(JNICALL* FromReflectedField)(JNIEnv*, jobject);
+    jobject(JNICALL* ToReflectedMethod)(JNIEnv*, jclass, jmethodID, jboolean);
+    jclass(JNICALL* GetSuperclass)(JNIEnv*, jclass);
+    jboolean(JNICALL* IsAssignableFrom)(JNIEnv*, jclass, jclass);
+    jobject(JNICALL* ToReflectedField)(JNIEnv*, jclass, jfieldID, jboolean);
+    jint(JNICALL* Throw)(JNIEnv*, jthrowable);
+    jint(JNICALL* ThrowNew)(JNIEnv*, jclass, const char*);
+    jthrowable(JNICALL* ExceptionOccurred)(JNIEnv*);
+    void(JNICALL* ExceptionDescribe)(JNIEnv*);
+    void(JNICALL* ExceptionClear)(JNIEnv*);
+    void(JNICALL* FatalError)(JNIEnv*, const char*);
+    jint(JNICALL* PushLocalFrame)(JNIEnv*, jint);
+    jobject(JNICALL* PopLocalFrame)(JNIEnv*, jobject);
+    jobject(JNICALL* NewGlobalRef)(JNIEnv*, jobject);
+    void(JNICALL* DeleteGlobalRef)(JNIEnv*, jobject);
+    void(JNICALL* DeleteLocalRef)(JNIEnv*, jobject);
+    jboolean(JNICALL* IsSameObject)(JNIEnv*, jobject, jobject);
+    jobject(JNICALL* NewLocalRef)(JNIEnv*, jobject);
+    jint(JNICALL* EnsureLocalCapacity)(JNIEnv*, jint);
+    jobject(JNICALL* AllocObject)(JNIEnv*, jclass);
+    jobject(JNICALL* NewObject)(JNIEnv*, jclass, jmethodID, ...);
+    jobject(JNICALL* NewObjectV)(JNIEnv*, jclass, jmethodID, va_list);
+    jobject(JNICALL* NewObjectA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jclass(JNICALL* GetObjectClass)(JNIEnv*, jobject);
+    jboolean(JNICALL* IsInstanceOf)(JNIEnv*, jobject, jclass);
+    jmethodID(JNICALL* GetMethodID)(JNIEnv*, jclass, const char*, const char*);
+    jobject(JNICALL* CallObjectMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jobject(JNICALL* CallObjectMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jobject(JNICALL* CallObjectMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jboolean(JNICALL* CallBooleanMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jboolean(JNICALL* CallBooleanMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jboolean(JNICALL* CallBooleanMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jbyte(JNICALL* CallByteMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jbyte(JNICALL* CallByteMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jbyte(JNICALL* CallByteMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jchar(JNICALL* CallCharMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jchar(JNICALL* CallCharMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jchar(JNICALL* CallCharMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jshort(JNICALL* CallShortMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jshort(JNICALL* CallShortMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jshort(JNICALL* CallShortMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jint(JNICALL* CallIntMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jint(JNICALL* CallIntMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jint(JNICALL* CallIntMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jlong(JNICALL* CallLongMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jlong(JNICALL* CallLongMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jlong(JNICALL* CallLongMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jfloat(JNICALL* CallFloatMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jfloat(JNICALL* CallFloatMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jfloat(JNICALL* CallFloatMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jdouble(JNICALL* CallDoubleMethod)(JNIEnv*, jobject, jmethodID, ...);
+    jdouble(JNICALL* CallDoubleMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    jdouble(JNICALL* CallDoubleMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    void(JNICALL* CallVoidMethod)(JNIEnv*, jobject, jmethodID, ...);
+    void(JNICALL* CallVoidMethodV)(JNIEnv*, jobject, jmethodID, va_list);
+    void(JNICALL* CallVoidMethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+    jobject(JNICALL* CallNonvirtualObjectMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jobject(JNICALL* CallNonvirtualObjectMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jobject(JNICALL* CallNonvirtualObjectMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jboolean(JNICALL* CallNonvirtualBooleanMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jboolean(JNICALL* CallNonvirtualBooleanMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jboolean(JNICALL* CallNonvirtualBooleanMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jbyte(JNICALL* CallNonvirtualByteMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jbyte(JNICALL* CallNonvirtualByteMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jbyte(JNICALL* CallNonvirtualByteMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jchar(JNICALL* CallNonvirtualCharMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jchar(JNICALL* CallNonvirtualCharMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jchar(JNICALL* CallNonvirtualCharMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jshort(JNICALL* CallNonvirtualShortMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jshort(JNICALL* CallNonvirtualShortMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jshort(JNICALL* CallNonvirtualShortMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jint(JNICALL* CallNonvirtualIntMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jint(JNICALL* CallNonvirtualIntMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jint(JNICALL* CallNonvirtualIntMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jlong(JNICALL* CallNonvirtualLongMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jlong(JNICALL* CallNonvirtualLongMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jlong(JNICALL* CallNonvirtualLongMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jfloat(JNICALL* CallNonvirtualFloatMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jfloat(JNICALL* CallNonvirtualFloatMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jfloat(JNICALL* CallNonvirtualFloatMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jdouble(JNICALL* CallNonvirtualDoubleMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    jdouble(JNICALL* CallNonvirtualDoubleMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    jdouble(JNICALL* CallNonvirtualDoubleMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    void(JNICALL* CallNonvirtualVoidMethod)(JNIEnv*, jobject, jclass, jmethodID, ...);
+    void(JNICALL* CallNonvirtualVoidMethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list);
+    void(JNICALL* CallNonvirtualVoidMethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+    jfieldID(JNICALL* GetFieldID)(JNIEnv*, jclass, const char*, const char*);
+    jobject(JNICALL* GetObjectField)(JNIEnv*, jobject, jfieldID);
+    jboolean(JNICALL* GetBooleanField)(JNIEnv*, jobject, jfieldID);
+    jbyte(JNICALL* GetByteField)(JNIEnv*, jobject, jfieldID);
+    jchar(JNICALL* GetCharField)(JNIEnv*, jobject, jfieldID);
+    jshort(JNICALL* GetShortField)(JNIEnv*, jobject, jfieldID);
+    jint(JNICALL* GetIntField)(JNIEnv*, jobject, jfieldID);
+    jlong(JNICALL* GetLongField)(JNIEnv*, jobject, jfieldID);
+    jfloat(JNICALL* GetFloatField)(JNIEnv*, jobject, jfieldID);
+    jdouble(JNICALL* GetDoubleField)(JNIEnv*, jobject, jfieldID);
+    void(JNICALL* SetObjectField)(JNIEnv*, jobject, jfieldID, jobject);
+    void(JNICALL* SetBooleanField)(JNIEnv*, jobject, jfieldID, jboolean);
+    void(JNICALL* SetByteField)(JNIEnv*, jobject, jfieldID, jbyte);
+    void(JNICALL* SetCharField)(JNIEnv*, jobject, jfieldID, jchar);
+    void(JNICALL* SetShortField)(JNIEnv*, jobject, jfieldID, jshort);
+    void(JNICALL* SetIntField)(JNIEnv*, jobject, jfieldID, jint);
+    void(JNICALL* SetLongField)(JNIEnv*, jobject, jfieldID, jlong);
+    void(JNICALL* SetFloatField)(JNIEnv*, jobject, jfieldID, jfloat);
+    void(JNICALL* SetDoubleField)(JNIEnv*, jobject, jfieldID, jdouble);
+    jmethodID(JNICALL* GetStaticMethodID)(JNIEnv*, jclass, const char*, const char*);
+    jobject(JNICALL* CallStaticObjectMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jobject(JNICALL* CallStaticObjectMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jobject(JNICALL* CallStaticObjectMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jboolean(JNICALL* CallStaticBooleanMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jboolean(JNICALL* CallStaticBooleanMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jboolean(JNICALL* CallStaticBooleanMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jbyte(JNICALL* CallStaticByteMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jbyte(JNICALL* CallStaticByteMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jbyte(JNICALL* CallStaticByteMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jchar(JNICALL* CallStaticCharMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jchar(JNICALL* CallStaticCharMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jchar(JNICALL* CallStaticCharMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jshort(JNICALL* CallStaticShortMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jshort(JNICALL* CallStaticShortMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jshort(JNICALL* CallStaticShortMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jint(JNICALL* CallStaticIntMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jint(JNICALL* CallStaticIntMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jint(JNICALL* CallStaticIntMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jlong(JNICALL* CallStaticLongMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jlong(JNICALL* CallStaticLongMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jlong(JNICALL* CallStaticLongMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jfloat(JNICALL* CallStaticFloatMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jfloat(JNICALL* CallStaticFloatMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jfloat(JNICALL* CallStaticFloatMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jdouble(JNICALL* CallStaticDoubleMethod)(JNIEnv*, jclass, jmethodID, ...);
+    jdouble(JNICALL* CallStaticDoubleMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    jdouble(JNICALL* CallStaticDoubleMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    void(JNICALL* CallStaticVoidMethod)(JNIEnv*, jclass, jmethodID, ...);
+    void(JNICALL* CallStaticVoidMethodV)(JNIEnv*, jclass, jmethodID, va_list);
+    void(JNICALL* CallStaticVoidMethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+    jfieldID(JNICALL* GetStaticFieldID)(JNIEnv*, jclass, const char*, const char*);
+    jobject(JNICALL* GetStaticObjectField)(JNIEnv*, jclass, jfieldID);
+    jboolean(JNICALL* GetStaticBooleanField)(JNIEnv*, jclass, jfieldID);
+    jbyte(JNICALL* GetStaticByteField)(JNIEnv*, jclass, jfieldID);
+    jchar(JNICALL* GetStaticCharField)(JNIEnv*, jclass, jfieldID);
+    jshort(JNICALL* GetStaticShortField)(JNIEnv*, jclass, jfieldID);
+    jint(JNICALL* GetStaticIntField)(JNIEnv*, jclass, jfieldID);
+    jlong(JNICALL* GetStaticLongField)(JNIEnv*, jclass, jfieldID);
+    jfloat(JNICALL* GetStaticFloatField)(JNIEnv*, jclass, jfieldID);
+    jdouble(JNICALL* GetStaticDoubleField)(JNIEnv*, jclass, jfieldID);
+    void(JNICALL* SetStaticObjectField)(JNIEnv*, jclass, jfieldID, jobject);
+    void(JNICALL* SetStaticBooleanField)(JNIEnv*, jclass, jfieldID, jboolean);
+    void(JNICALL* SetStaticByteField)(JNIEnv*, jclass, jfieldID, jbyte);
+    void(JNICALL* SetStaticCharField)(JNIEnv*, jclass, jfieldID, jchar);
+    void(JNICALL* SetStaticShortField)(JNIEnv*, jclass, jfieldID, jshort);
+    void(JNICALL* SetStaticIntField)(JNIEnv*, jclass, jfieldID, jint);
+    void(JNICALL* SetStaticLongField)(JNIEnv*, jclass, jfieldID, jlong);
+    void(JNICALL* SetStaticFloatField)(JNIEnv*, jclass, jfieldID, jfloat);
+    void(JNICALL* SetStaticDoubleField)(JNIEnv*, jclass, jfieldID, jdouble);
+    jstring(JNICALL* NewString)(JNIEnv*, const jchar*, jsize);
+    jsize(JNICALL* GetStringLength)(JNIEnv*, jstring);
+    const jchar*(JNICALL* GetStringChars)(JNIEnv*, jstring, jboolean*);
+    void(JNICALL* ReleaseStringChars)(JNIEnv*, jstring, const jchar*);
+    jstring(JNICALL* NewStringUTF)(JNIEnv*, const char*);
+    jsize(JNICALL* GetStringUTFLength)(JNIEnv*, jstring);
+    const char*(JNICALL* GetStringUTFChars)(JNIEnv*, jstring, jboolean*);
+    void(JNICALL* ReleaseStringUTFChars)(JNIEnv*, jstring, const char*);
+    jsize(JNICALL* GetArrayLength)(JNIEnv*, jarray);
+    jobjectArray(JNICALL* NewObjectArray)(JNIEnv*, jsize, jclass, jobject);
+    jobject(JNICALL* GetObjectArrayElement)(JNIEnv*, jobjectArray, jsize);
+    void(JNICALL* SetObjectArrayElement)(JNIEnv*, jobjectArray, jsize, jobject);
+    jbooleanArray(JNICALL* NewBooleanArray)(JNIEnv*, jsize);
+    jbyteArray(JNICALL* NewByteArray)(JNIEnv*, jsize);
+    jcharArray(JNICALL* NewCharArray)(JNIEnv*, jsize);
+    jshortArray(JNICALL* NewShortArray)(JNIEnv*, jsize);
+    jintArray(JNICALL* NewIntArray)(JNIEnv*, jsize);
+    jlongArray(JNICALL* NewLongArray)(JNIEnv*, jsize);
+    jfloatArray(JNICALL* NewFloatArray)(JNIEnv*, jsize);
+    jdoubleArray(JNICALL* NewDoubleArray)(JNIEnv*, jsize);
+    jboolean*(JNICALL* GetBooleanArrayElements)(JNIEnv*, jbooleanArray, jboolean*);
+    jbyte*(JNICALL* GetByteArrayElements)(JNIEnv*, jbyteArray, jboolean*);
+    jchar*(JNICALL* GetCharArrayElements)(JNIEnv*, jcharArray, jboolean*);
+    jshort*(JNICALL* GetShortArrayElements)(JNIEnv*, jshortArray, jboolean*);
+    jint*(JNICALL* GetIntArrayElements)(JNIEnv*, jintArray, jboolean*);
+    jlong*(JNICALL* GetLongArrayElements)(JNIEnv*, jlongArray, jboolean*);
+    jfloat*(JNICALL* GetFloatArrayElements)(JNIEnv*, jfloatArray, jboolean*);
+    jdouble*(JNICALL* GetDoubleArrayElements)(JNIEnv*, jdoubleArray, jboolean*);
+    void(JNICALL* ReleaseBooleanArrayElements)(JNIEnv*, jbooleanArray, jboolean*, jint);
+    void(JNICALL* ReleaseByteArrayElements)(JNIEnv*, jbyteArray, jbyte*, jint);
+    void(JNICALL* ReleaseCharArrayElements)(JNIEnv*, jcharArray, jchar*, jint);
+    void(JNICALL* ReleaseShortArrayElements)(JNIEnv*, jshortArray, jshort*, jint);
+    void(JNICALL* ReleaseIntArrayElements)(JNIEnv*, jintArray, jint*, jint);
+    void(JNICALL* ReleaseLongArrayElements)(JNIEnv*, jlongArray, jlong*, jint);
+    void(JNICALL* ReleaseFloatArrayElements)(JNIEnv*, jfloatArray, jfloat*, jint);
+    void(JNICALL* ReleaseDoubleArrayElements)(JNIEnv*, jdoubleArray, jdouble*, jint);
+    void(JNICALL* GetBooleanArrayRegion)(JNIEnv*, jbooleanArray, jsize, jsize, jboolean*);
+    void(JNICALL* GetByteArrayRegion)(JNIEnv*, jbyteArray, jsize, jsize, jbyte*);
+    void(JNICALL* GetCharArrayRegion)(JNIEnv*, jcharArray, jsize, jsize, jchar*);
+    void(JNICALL* GetShortArrayRegion)(JNIEnv*, jshortArray, jsize, jsize, jshort*);
+    void(JNICALL* GetIntArrayRegion)(JNIEnv*, jintArray, jsize, jsize, jint*);
+    void(JNICALL* GetLongArrayRegion)(JNIEnv*, jlongArray, jsize, jsize, jlong*);
+    void(JNICALL* GetFloatArrayRegion)(JNIEnv*, jfloatArray, jsize, jsize, jfloat*);
+    void(JNICALL* GetDoubleArrayRegion)(JNIEnv*, jdoubleArray, jsize, jsize, jdouble*);
+    void(JNICALL* SetBooleanArrayRegion)(JNIEnv*, jbooleanArray, jsize, jsize, const jboolean*);
+    void(JNICALL* SetByteArrayRegion)(JNIEnv*, jbyteArray, jsize, jsize, const jbyte*);
+    void(JNICALL* SetCharArrayRegion)(JNIEnv*, jcharArray, jsize, jsize, const jchar*);
+    void(JNICALL* SetShortArrayRegion)(JNIEnv*, jshortArray, jsize, jsize, const jshort*);
+    void(JNICALL* SetIntArrayRegion)(JNIEnv*, jintArray, jsize, jsize, const jint*);
+    void(JNICALL* SetLongArrayRegion)(JNIEnv*, jlongArray, jsize, jsize, const jlong*);
+    void(JNICALL* SetFloatArrayRegion)(JNIEnv*, jfloatArray, jsize, jsize, const jfloat*);
+    void(JNICALL* SetDoubleArrayRegion)(JNIEnv*, jdoubleArray, jsize, jsize, const jdouble*);
+    jint(JNICALL* RegisterNatives)(JNIEnv*, jclass, const JNINativeMethod*, jint);
+    jint(JNICALL* UnregisterNatives)(JNIEnv*, jclass);
+    jint(JNICALL* MonitorEnter)(JNIEnv*, jobject);
+    jint(JNICALL* MonitorExit)(JNIEnv*, jobject);
+    jint(JNICALL* GetJavaVM)(JNIEnv*, JavaVM**);
+    void(JNICALL* GetStringRegion)(JNIEnv*, jstring, jsize, jsize, jchar*);
+    void(JNICALL* GetStringUTFRegion)(JNIEnv*, jstring, jsize, jsize, char*);
+    void*(JNICALL* GetPrimitiveArrayCritical)(JNIEnv*, jarray, jboolean*);
+    void(JNICALL* ReleasePrimitiveArrayCritical)(JNIEnv*, jarray, void*, jint);
+    const jchar*(JNICALL* GetStringCritical)(JNIEnv*, jstring, jboolean*);
+    void(JNICALL* ReleaseStringCritical)(JNIEnv*, jstring, const jchar*);
+    jweak(JNICALL* NewWeakGlobalRef)(JNIEnv*, jobject);
+    void(JNICALL* DeleteWeakGlobalRef)(JNIEnv*, jweak);
+    jboolean(JNICALL* ExceptionCheck)(JNIEnv*);
+    jobject(JNICALL* NewDirectByteBuffer)(JNIEnv*, void*, jlong);
+    void*(JNICALL* GetDirectBufferAddress)(JNIEnv*, jobject);
+    jlong(JNICALL* GetDirectBufferCapacity)(JNIEnv*, jobject);
+    jobjectRefType(JNICALL* GetObjectRefType)(JNIEnv*, jobject);
+    jobject(JNICALL* GetModule)(JNIEnv*, jclass);
+};
+
+struct JNIEnv_ {
+    const JNINativeInterface_* functions;
+
+    jint GetVersion() { return functions->GetVersion(this); }
+    jclass DefineClass(const char* name, jobject loader, const jbyte* buffer, jsize size) {
+        return functions->DefineClass(this, name, loader, buffer, size);
+    }
+    jclass FindClass(const char* name) { return functions->FindClass(this, name); }
+    jmethodID FromReflectedMethod(jobject method) { return functions->FromReflectedMethod(this, method); }
+    jfieldID FromReflectedField(jobject field) { return functions->FromReflectedField(this, field); }
+    jobject ToReflectedMethod(jclass type, jmethodID method, jboolean isStatic) {
+        return functions->ToReflectedMethod(this, type, method, isStatic);
+    }
+    jclass GetSuperclass(jclass type) { return functions->GetSuperclass(this, type); }
+    jboolean IsAssignableFrom(jclass from, jclass to) { return functions->IsAssignableFrom(this, from, to); }
+    jobject ToReflectedField(jclass type, jfieldID field, jboolean isStatic) {
+        return functions->ToReflectedField(this, type, field, isStatic);
+    }
+    jint Throw(jthrowable throwable) { return functions->Throw(this, throwable); }
+    jint ThrowNew(jclass type, const char* message) { return functions->ThrowNew(this, type, message); }
+    jthrowable ExceptionOccurred() { return functions->ExceptionOccurred(this); }
+    void ExceptionDescribe() { functions->ExceptionDescribe(this); }
+    void ExceptionClear() { functions->ExceptionClear(this); }
+    void FatalError(const char* message) { functions->FatalError(this, message); }
+    jint PushLocalFrame(jint capacity) { return functions->PushLocalFrame(this, capacity); }
+    jobject PopLocalFrame(jobject result) { return functions->PopLocalFrame(this, result); }
+    jobject NewGlobalRef(jobject ref) { return functions->NewGlobalRef(this, ref); }
+    void DeleteGlobalRef(jobject ref) { functions->DeleteGlobalRef(this, ref); }
+    void DeleteLocalRef(jobject ref) { functions->DeleteLocalRef(this, ref); }
+    jboolean IsSameObject(jobject a, jobject b) { return functions->IsSameObject(this, a, b); }
+    jobject NewLocalRef(jobject ref) { return functions->NewLocalRef(this, ref); }
+    jint EnsureLocalCapacity(jint capacity) { return functions->EnsureLocalCapacity(this, capacity); }
+    jobject AllocObject(jclass type) { return functions->AllocObject(this, type); }
+    jobject NewObject(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jobject result = functions->NewObjectV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jobject NewObjectV(jclass type, jmethodID method, va_list args) {
+        return functions->NewObjectV(this, type, method, args);
+    }
+    jobject NewObjectA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->NewObjectA(this, type, method, args);
+    }
+    jclass GetObjectClass(jobject object) { return functions->GetObjectClass(this, object); }
+    jboolean IsInstanceOf(jobject object, jclass type) { return functions->IsInstanceOf(this, object, type); }
+    jmethodID GetMethodID(jclass type, const char* name, const char* signature) {
+        return functions->GetMethodID(this, type, name, signature);
+    }
+    jobject CallObjectMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jobject result = functions->CallObjectMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jobject CallObjectMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallObjectMethodV(this, object, method, args);
+    }
+    jobject CallObjectMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallObjectMethodA(this, object, method, args);
+    }
+    jboolean CallBooleanMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jboolean result = functions->CallBooleanMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jboolean CallBooleanMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallBooleanMethodV(this, object, method, args);
+    }
+    jboolean CallBooleanMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallBooleanMethodA(this, object, method, args);
+    }
+    jbyte CallByteMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jbyte result = functions->CallByteMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jbyte CallByteMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallByteMethodV(this, object, method, args);
+    }
+    jbyte CallByteMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallByteMethodA(this, object, method, args);
+    }
+    jchar CallCharMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jchar result = functions->CallCharMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jchar CallCharMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallCharMethodV(this, object, method, args);
+    }
+    jchar CallCharMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallCharMethodA(this, object, method, args);
+    }
+    jshort CallShortMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jshort result = functions->CallShortMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jshort CallShortMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallShortMethodV(this, object, method, args);
+    }
+    jshort CallShortMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallShortMethodA(this, object, method, args);
+    }
+    jint CallIntMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jint result = functions->CallIntMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jint CallIntMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallIntMethodV(this, object, method, args);
+    }
+    jint CallIntMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallIntMethodA(this, object, method, args);
+    }
+    jlong CallLongMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jlong result = functions->CallLongMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jlong CallLongMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallLongMethodV(this, object, method, args);
+    }
+    jlong CallLongMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallLongMethodA(this, object, method, args);
+    }
+    jfloat CallFloatMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jfloat result = functions->CallFloatMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jfloat CallFloatMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallFloatMethodV(this, object, method, args);
+    }
+    jfloat CallFloatMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallFloatMethodA(this, object, method, args);
+    }
+    jdouble CallDoubleMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jdouble result = functions->CallDoubleMethodV(this, object, method, args);
+        va_end(args);
+        return result;
+    }
+    jdouble CallDoubleMethodV(jobject object, jmethodID method, va_list args) {
+        return functions->CallDoubleMethodV(this, object, method, args);
+    }
+    jdouble CallDoubleMethodA(jobject object, jmethodID method, const jvalue* args) {
+        return functions->CallDoubleMethodA(this, object, method, args);
+    }
+    void CallVoidMethod(jobject object, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        functions->CallVoidMethodV(this, object, method, args);
+        va_end(args);
+    }
+    void CallVoidMethodV(jobject object, jmethodID method, va_list args) {
+        functions->CallVoidMethodV(this, object, method, args);
+    }
+    void CallVoidMethodA(jobject object, jmethodID method, const jvalue* args) {
+        functions->CallVoidMethodA(this, object, method, args);
+    }
+    jobject CallNonvirtualObjectMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jobject result = functions->CallNonvirtualObjectMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jobject CallNonvirtualObjectMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualObjectMethodV(this, object, type, method, args);
+    }
+    jobject CallNonvirtualObjectMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualObjectMethodA(this, object, type, method, args);
+    }
+    jboolean CallNonvirtualBooleanMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jboolean result = functions->CallNonvirtualBooleanMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jboolean CallNonvirtualBooleanMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualBooleanMethodV(this, object, type, method, args);
+    }
+    jboolean CallNonvirtualBooleanMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualBooleanMethodA(this, object, type, method, args);
+    }
+    jbyte CallNonvirtualByteMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jbyte result = functions->CallNonvirtualByteMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jbyte CallNonvirtualByteMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualByteMethodV(this, object, type, method, args);
+    }
+    jbyte CallNonvirtualByteMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualByteMethodA(this, object, type, method, args);
+    }
+    jchar CallNonvirtualCharMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jchar result = functions->CallNonvirtualCharMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jchar CallNonvirtualCharMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualCharMethodV(this, object, type, method, args);
+    }
+    jchar CallNonvirtualCharMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualCharMethodA(this, object, type, method, args);
+    }
+    jshort CallNonvirtualShortMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jshort result = functions->CallNonvirtualShortMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jshort CallNonvirtualShortMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualShortMethodV(this, object, type, method, args);
+    }
+    jshort CallNonvirtualShortMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualShortMethodA(this, object, type, method, args);
+    }
+    jint CallNonvirtualIntMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jint result = functions->CallNonvirtualIntMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jint CallNonvirtualIntMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualIntMethodV(this, object, type, method, args);
+    }
+    jint CallNonvirtualIntMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualIntMethodA(this, object, type, method, args);
+    }
+    jlong CallNonvirtualLongMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jlong result = functions->CallNonvirtualLongMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jlong CallNonvirtualLongMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualLongMethodV(this, object, type, method, args);
+    }
+    jlong CallNonvirtualLongMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualLongMethodA(this, object, type, method, args);
+    }
+    jfloat CallNonvirtualFloatMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jfloat result = functions->CallNonvirtualFloatMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jfloat CallNonvirtualFloatMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualFloatMethodV(this, object, type, method, args);
+    }
+    jfloat CallNonvirtualFloatMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualFloatMethodA(this, object, type, method, args);
+    }
+    jdouble CallNonvirtualDoubleMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jdouble result = functions->CallNonvirtualDoubleMethodV(this, object, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jdouble CallNonvirtualDoubleMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        return functions->CallNonvirtualDoubleMethodV(this, object, type, method, args);
+    }
+    jdouble CallNonvirtualDoubleMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallNonvirtualDoubleMethodA(this, object, type, method, args);
+    }
+    void CallNonvirtualVoidMethod(jobject object, jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        functions->CallNonvirtualVoidMethodV(this, object, type, method, args);
+        va_end(args);
+    }
+    void CallNonvirtualVoidMethodV(jobject object, jclass type, jmethodID method, va_list args) {
+        functions->CallNonvirtualVoidMethodV(this, object, type, method, args);
+    }
+    void CallNonvirtualVoidMethodA(jobject object, jclass type, jmethodID method, const jvalue* args) {
+        functions->CallNonvirtualVoidMethodA(this, object, type, method, args);
+    }
+    jfieldID GetFieldID(jclass type, const char* name, const char* signature) {
+        return functions->GetFieldID(this, type, name, signature);
+    }
+    jobject GetObjectField(jobject object, jfieldID field) { return functions->GetObjectField(this, object, field); }
+    jboolean GetBooleanField(jobject object, jfieldID field) { return functions->GetBooleanField(this, object, field); }
+    jbyte GetByteField(jobject object, jfieldID field) { return functions->GetByteField(this, object, field); }
+    jchar GetCharField(jobject object, jfieldID field) { return functions->GetCharField(this, object, field); }
+    jshort GetShortField(jobject object, jfieldID field) { return functions->GetShortField(this, object, field); }
+    jint GetIntField(jobject object, jfieldID field) { return functions->GetIntField(this, object, field); }
+    jlong GetLongField(jobject object, jfieldID field) { return functions->GetLongField(this, object, field); }
+    jfloat GetFloatField(jobject object, jfieldID field) { return functions->GetFloatField(this, object, field); }
+    jdouble GetDoubleField(jobject object, jfieldID field) { return functions->GetDoubleField(this, object, field); }
+    void SetObjectField(jobject object, jfieldID field, jobject value) {
+        functions->SetObjectField(this, object, field, value);
+    }
+    void SetBooleanField(jobject object, jfieldID field, jboolean value) {
+        functions->SetBooleanField(this, object, field, value);
+    }
+    void SetByteField(jobject object, jfieldID field, jbyte value) {
+        functions->SetByteField(this, object, field, value);
+    }
+    void SetCharField(jobject object, jfieldID field, jchar value) {
+        functions->SetCharField(this, object, field, value);
+    }
+    void SetShortField(jobject object, jfieldID field, jshort value) {
+        functions->SetShortField(this, object, field, value);
+    }
+    void SetIntField(jobject object, jfieldID field, jint value) { functions->SetIntField(this, object, field, value); }
+    void SetLongField(jobject object, jfieldID field, jlong value) {
+        functions->SetLongField(this, object, field, value);
+    }
+    void SetFloatField(jobject object, jfieldID field, jfloat value) {
+        functions->SetFloatField(this, object, field, value);
+    }
+    void SetDoubleField(jobject object, jfieldID field, jdouble value) {
+        functions->SetDoubleField(this, object, field, value);
+    }
+    jmethodID GetStaticMethodID(jclass type, const char* name, const char* signature) {
+        return functions->GetStaticMethodID(this, type, name, signature);
+    }
+    jobject CallStaticObjectMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jobject result = functions->CallStaticObjectMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jobject CallStaticObjectMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticObjectMethodV(this, type, method, args);
+    }
+    jobject CallStaticObjectMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticObjectMethodA(this, type, method, args);
+    }
+    jboolean CallStaticBooleanMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jboolean result = functions->CallStaticBooleanMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jboolean CallStaticBooleanMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticBooleanMethodV(this, type, method, args);
+    }
+    jboolean CallStaticBooleanMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticBooleanMethodA(this, type, method, args);
+    }
+    jbyte CallStaticByteMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jbyte result = functions->CallStaticByteMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jbyte CallStaticByteMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticByteMethodV(this, type, method, args);
+    }
+    jbyte CallStaticByteMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticByteMethodA(this, type, method, args);
+    }
+    jchar CallStaticCharMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jchar result = functions->CallStaticCharMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jchar CallStaticCharMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticCharMethodV(this, type, method, args);
+    }
+    jchar CallStaticCharMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticCharMethodA(this, type, method, args);
+    }
+    jshort CallStaticShortMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jshort result = functions->CallStaticShortMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jshort CallStaticShortMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticShortMethodV(this, type, method, args);
+    }
+    jshort CallStaticShortMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticShortMethodA(this, type, method, args);
+    }
+    jint CallStaticIntMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jint result = functions->CallStaticIntMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jint CallStaticIntMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticIntMethodV(this, type, method, args);
+    }
+    jint CallStaticIntMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticIntMethodA(this, type, method, args);
+    }
+    jlong CallStaticLongMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jlong result = functions->CallStaticLongMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jlong CallStaticLongMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticLongMethodV(this, type, method, args);
+    }
+    jlong CallStaticLongMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticLongMethodA(this, type, method, args);
+    }
+    jfloat CallStaticFloatMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jfloat result = functions->CallStaticFloatMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jfloat CallStaticFloatMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticFloatMethodV(this, type, method, args);
+    }
+    jfloat CallStaticFloatMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticFloatMethodA(this, type, method, args);
+    }
+    jdouble CallStaticDoubleMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        jdouble result = functions->CallStaticDoubleMethodV(this, type, method, args);
+        va_end(args);
+        return result;
+    }
+    jdouble CallStaticDoubleMethodV(jclass type, jmethodID method, va_list args) {
+        return functions->CallStaticDoubleMethodV(this, type, method, args);
+    }
+    jdouble CallStaticDoubleMethodA(jclass type, jmethodID method, const jvalue* args) {
+        return functions->CallStaticDoubleMethodA(this, type, method, args);
+    }
+    void CallStaticVoidMethod(jclass type, jmethodID method, ...) {
+        va_list args;
+        va_start(args, method);
+        functions->CallStaticVoidMethodV(this, type, method, args);
+        va_end(args);
+    }
+    void CallStaticVoidMethodV(jclass type, jmethodID method, va_list args) {
+        functions->CallStaticVoidMethodV(this, type, method, args);
+    }
+    void CallStaticVoidMethodA(jclass type, jmethodID method, const jvalue* args) {
+        functions->CallStaticVoidMethodA(this, type, method, args);
+    }
+    jfieldID GetStaticFieldID(jclass type, const char* name, const char* signature) {
+        return functions->GetStaticFieldID(this, type, name, signature);
+    }
+    jobject GetStaticObjectField(jclass type, jfieldID field) {
+        return functions->GetStaticObjectField(this, type, field);
+    }
+    jboolean GetStaticBooleanField(jclass type, jfieldID field) {
+        return functions->GetStaticBooleanField(this, type, field);
+    }
+    jbyte GetStaticByteField(jclass type, jfieldID field) { return functions->GetStaticByteField(this, type, field); }
+    jchar GetStaticCharField(jclass type, jfieldID field) { return functions->GetStaticCharField(this, type, field); }
+    jshort GetStaticShortField(jclass type, jfieldID field) {
+        return functions->GetStaticShortField(this, type, field);
+    }
+    jint GetStaticIntField(jclass type, jfieldID field) { return functions->GetStaticIntField(this, type, field); }
+    jlong GetStaticLongField(jclass type, jfieldID field) { return functions->GetStaticLongField(this, type, field); }
+    jfloat GetStaticFloatField(jclass type, jfieldID field) {
+        return functions->GetStaticFloatField(this, type, field);
+    }
+    jdouble GetStaticDoubleField(jclass type, jfieldID field) {
+        return functions->GetStaticDoubleField(this, type, field);
+    }
+    void SetStaticObjectField(jclass type, jfieldID field, jobject value) {
+        functions->SetStaticObjectField(this, type, field, value);
+    }
+    void SetStaticBooleanField(jclass type, jfieldID field, jboolean value) {
+        functions->SetStaticBooleanField(this, type, field, value);
+    }
+    void SetStaticByteField(jclass type, jfieldID field, jbyte value) {
+        functions->SetStaticByteField(this, type, field, value);
+    }
+    void SetStaticCharField(jclass type, jfieldID field, jchar value) {
+        functions->SetStaticCharField(this, type, field, value);
+    }
+    void SetStaticShortField(jclass type, jfieldID field, jshort value) {
+        functions->SetStaticShortField(this, type, field, value);
+    }
+    void SetStaticIntField(jclass type, jfieldID field, jint value) {
+        functions->SetStaticIntField(this, type, field, value);
+    }
+    void SetStaticLongField(jclass type, jfieldID field, jlong value) {
+        functions->SetStaticLongField(this, type, field, value);
+    }
+    void SetStaticFloatField(jclass type, jfieldID field, jfloat value) {
+        functions->SetStaticFloatField(this, type, field, value);
+    }
+    void SetStaticDoubleField(jclass type, jfieldID field, jdouble value) {
+        functions->SetStaticDoubleField(this, type, field, value);
+    }
+    jstring NewString(const jchar* chars, jsize size) { return functions->NewString(this, chars, size); }
+    jsize GetStringLength(jstring string) { return functions->GetStringLength(this, string); }
+    const jchar* GetStringChars(jstring string, jboolean* isCopy) {
+        return functions->GetStringChars(this, string, isCopy);
+    }
+    void ReleaseStringChars(jstring string, const jchar* chars) { functions->ReleaseStringChars(this, string, chars); }
+    jstring NewStringUTF(const char* chars) { return functions->NewStringUTF(this, chars); }
+    jsize GetStringUTFLength(jstring string) { return functions->GetStringUTFLength(this, string); }
+    const char* GetStringUTFChars(jstring string, jboolean* isCopy) {
+        return functions->GetStringUTFChars(this, string, isCopy);
+    }
+    void ReleaseStringUTFChars(jstring string, const char* chars) {
+        functions->ReleaseStringUTFChars(this, string, chars);
+    }
+    jsize GetArrayLength(jarray array) { return functions->GetArrayLength(this, array); }
+    jobjectArray NewObjectArray(jsize size, jclass type, jobject initial) {
+        return functions->NewObjectArray(this, size, type, initial);
+    }
+    jobject GetObjectArrayElement(jobjectArray array, jsize index) {
+        return functions->GetObjectArrayElement(this, array, index);
+    }
+    void SetObjectArrayElement(jobjectArray array, jsize index, jobject value) {
+        functions->SetObjectArrayElement(this, array, index, value);
+    }
+    jbooleanArray NewBooleanArray(jsize size) { return functions->NewBooleanArray(this, size); }
+    jbyteArray NewByteArray(jsize size) { return functions->NewByteArray(this, size); }
+    jcharArray NewCharArray(jsize size) { return functions->NewCharArray(this, size); }
+    jshortArray NewShortArray(jsize size) { return functions->NewShortArray(this, size); }
+    jintArray NewIntArray(jsize size) { return functions->NewIntArray(this, size); }
+    jlongArray NewLongArray(jsize size) { return functions->NewLongArray(this, size); }
+    jfloatArray NewFloatArray(jsize size) { return functions->NewFloatArray(this, size); }
+    jdoubleArray NewDoubleArray(jsize size) { return functions->NewDoubleArray(this, size); }
+    jboolean* GetBooleanArrayElements(jbooleanArray array, jboolean* isCopy) {
+        return functions->GetBooleanArrayElements(this, array, isCopy);
+    }
+    jbyte* GetByteArrayElements(jbyteArray array, jboolean* isCopy) {
+        return functions->GetByteArrayElements(this, array, isCopy);
+    }
+    jchar* GetCharArrayElements(jcharArray array, jboolean* isCopy) {
+        return functions->GetCharArrayElements(this, array, isCopy);
+    }
+    jshort* GetShortArrayElements(jshortArray array, jboolean* isCopy) {
+        return functions->GetShortArrayElements(this, array, isCopy);
+    }
+    jint* GetIntArrayElements(jintArray array, jboolean* isCopy) {
+        return functions->GetIntArrayElements(this, array, isCopy);
+    }
+    jlong* GetLongArrayElements(jlongArray array, jboolean* isCopy) {
+        return functions->GetLongArrayElements(this, array, isCopy);
+    }
+    jfloat* GetFloatArrayElements(jfloatArray array, jboolean* isCopy) {
+        return functions->GetFloatArrayElements(this, array, isCopy);
+    }
+    jdouble* GetDoubleArrayElements(jdoubleArray array, jboolean* isCopy) {
+        return functions->GetDoubleArrayElements(this, array, isCopy);
+    }
+    void ReleaseBooleanArrayElements(jbooleanArray array, jboolean* elements, jint mode) {
+        functions->ReleaseBooleanArrayElements(this, array, elements, mode);
+    }
+    void ReleaseByteArrayElements(jbyteArray array, jbyte* elements, jint mode) {
+        functions->ReleaseByteArrayElements(this, array, elements, mode);
+    }
+    void ReleaseCharArrayElements(jcharArray array, jchar* elements, jint mode) {
+        functions->ReleaseCharArrayElements(this, array, elements, mode);
+    }
+    void ReleaseShortArrayElements(jshortArray array, jshort* elements, jint mode) {
+        functions->ReleaseShortArrayElements(this, array, elements, mode);
+    }
+    void ReleaseIntArrayElements(jintArray array, jint* elements, jint mode) {
+        functions->ReleaseIntArrayElements(this, array, elements, mode);
+    }
+    void ReleaseLongArrayElements(jlongArray array, jlong* elements, jint mode) {
+        functions->ReleaseLongArrayElements(this, array, elements, mode);
+    }
+    void ReleaseFloatArrayElements(jfloatArray array, jfloat* elements, jint mode) {
+        functions->ReleaseFloatArrayElements(this, array, elements, mode);
+    }
+    void ReleaseDoubleArrayElements(jdoubleArray array, jdouble* elements, jint mode) {
+        functions->ReleaseDoubleArrayElements(this, array, elements, mode);
+    }
+    void GetBooleanArrayRegion(jbooleanArray array, jsize start, jsize size, jboolean* buffer) {
+        functions->GetBooleanArrayRegion(this, array, start, size, buffer);
+    }
+    void GetByteArrayRegion(jbyteArray array, jsize start, jsize size, jbyte* buffer) {
+        functions->GetByteArrayRegion(this, array, start, size, buffer);
+    }
+    void GetCharArrayRegion(jcharArray array, jsize start, jsize size, jchar* buffer) {
+        functions->GetCharArrayRegion(this, array, start, size, buffer);
+    }
+    void GetShortArrayRegion(jshortArray array, jsize start, jsize size, jshort* buffer) {
+        functions->GetShortArrayRegion(this, array, start, size, buffer);
+    }
+    void GetIntArrayRegion(jintArray array, jsize start, jsize size, jint* buffer) {
+        functions->GetIntArrayRegion(this, array, start, size, buffer);
+    }
+    void GetLongArrayRegion(jlongArray array, jsize start, jsize size, jlong* buffer) {
+        functions->GetLongArrayRegion(this, array, start, size, buffer);
+    }
+    void GetFloatArrayRegion(jfloatArray array, jsize start, jsize size, jfloat* buffer) {
+        functions->GetFloatArrayRegion(this, array, start, size, buffer);
+    }
+    void GetDoubleArrayRegion(jdoubleArray array, jsize start, jsize size, jdouble* buffer) {
+        functions->GetDoubleArrayRegion(this, array, start, size, buffer);
+    }
+    void SetBooleanArrayRegion(jbooleanArray array, jsize start, jsize size, const jboolean* buffer) {
+        functions->SetBooleanArrayRegion(this, array, start, size, buffer);
+    }
+    void SetByteArrayRegion(jbyteArray array, jsize start, jsize size, const jbyte* buffer) {
+        functions->SetByteArrayRegion(this, array, start, size, buffer);
+    }
+    void SetCharArrayRegion(jcharArray array, jsize start, jsize size, const jchar* buffer) {
+        functions->SetCharArrayRegion(this, array, start, size, buffer);
+    }
+    void SetShortArrayRegion(jshortArray array, jsize start, jsize size, const jshort* buffer) {
+        functions->SetShortArrayRegion(this, array, start, size, buffer);
+    }
+    void SetIntArrayRegion(jintArray array, jsize start, jsize size, const jint* buffer) {
+        functions->SetIntArrayRegion(this, array, start, size, buffer);
+    }
+    void SetLongArrayRegion(jlongArray array, jsize start, jsize size, const jlong* buffer) {
+        functions->SetLongArrayRegion(this, array, start, size, buffer);
+    }
+    void SetFloatArrayRegion(jfloatArray array, jsize start, jsize size, const jfloat* buffer) {
+        functions->SetFloatArrayRegion(this, array, start, size, buffer);
+    }
+    void SetDoubleArrayRegion(jdoubleArray array, jsize start, jsize size, const jdouble* buffer) {
+        functions->SetDoubleArrayRegion(this, array, start, size, buffer);
+    }
+    jint RegisterNatives(jclass type, const JNINativeMethod* methods, jint count) {
+        return functions->RegisterNatives(this, type, methods, count);
+    }
+    jint UnregisterNatives(jclass type) { return functions->UnregisterNatives(this, type); }
+    jint MonitorEnter(jobject object) { return functions->MonitorEnter(this, object); }
+    jint MonitorExit(jobject object) { return functions->MonitorExit(this, object); }
+    jint GetJavaVM(JavaVM** vm) { return functions->GetJavaVM(this, vm); }
+    void GetStringRegion(jstring string, jsize start, jsize size, jchar* buffer) {
+        functions->GetStringRegion(this, string, start, size, buffer);
+    }
+    void GetStringUTFRegion(jstring string, jsize start, jsize size, char* buffer) {
+        functions->GetStringUTFRegion(this, string, start, size, buffer);
+    }
+    void* GetPrimitiveArrayCritical(jarray array, jboolean* isCopy) {
+        return functions->GetPrimitiveArrayCritical(this, array, isCopy);
+    }
+    void ReleasePrimitiveArrayCritical(jarray array, void* data, jint mode) {
+        functions->ReleasePrimitiveArrayCritical(this, array, data, mode);
+    }
+    const jchar* GetStringCritical(jstring string, jboolean* isCopy) {
+        return functions->GetStringCritical(this, string, isCopy);
+    }
+    void ReleaseStringCritical(jstring string, const jchar* chars) {
+        functions->ReleaseStringCritical(this, string, chars);
+    }
+    jweak NewWeakGlobalRef(jobject object) { return functions->NewWeakGlobalRef(this, object); }
+    void DeleteWeakGlobalRef(jweak ref) { functions->DeleteWeakGlobalRef(this, ref); }
+    jboolean ExceptionCheck() { return functions->ExceptionCheck(this); }
+    jobject NewDirectByteBuffer(void* address, jlong capacity) {
+        return functions->NewDirectByteBuffer(this, address, capacity);
+    }
+    void* GetDirectBufferAddress(jobject buffer) { return functions->GetDirectBufferAddress(this, buffer); }
+    jlong GetDirectBufferCapacity(jobject buffer) { return functions->GetDirectBufferCapacity(this, buffer); }
+    jobjectRefType GetObjectRefType(jobject object) { return functions->GetObjectRefType(this, object); }
+    jobject GetModule(jclass type) { return functions->GetModule(this, type); }
+};
+
+struct JNIInvokeInterface_ {
+    void* reserved0;
+    void* reserved1;
+    void* reserved2;
+    jint(JNICALL* DestroyJavaVM)(JavaVM*);
+    jint(JNICALL* AttachCurrentThread)(JavaVM*, void**, void*);
+    jint(JNICALL* DetachCurrentThread)(JavaVM*);
+    jint(JNICALL* GetEnv)(JavaVM*, void**, jint);
+    jint(JNICALL* AttachCurrentThreadAsDaemon)(JavaVM*, void**, void*);
+};
+
+struct JavaVM_ {
+    const JNIInvokeInterface_* functions;
+
+    jint DestroyJavaVM() { return functions->DestroyJavaVM(this); }
+    jint AttachCurrentThread(void** env, void* args) { return functions->AttachCurrentThread(this, env, args); }
+    jint DetachCurrentThread() { return functions->DetachCurrentThread(this); }
+    jint GetEnv(void** env, jint version) { return functions->GetEnv(this, env, version); }
+    jint AttachCurrentThreadAsDaemon(void** env, void* args) {
+        return functions->AttachCurrentThreadAsDaemon(this, env, args);
+    }
+};
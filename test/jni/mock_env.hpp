@@ -0,0 +1,228 @@
+#pragma once
+
+#include <jni/jni.hpp>
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mapbox/jni/bulk.hpp"
+
+// A `JNIEnv` backed by a function table implementing the subset of JNI used
+// by the bulk converters and the jni.hpp functions they call, so that they
+// can be tested without a JVM. Objects are owned by the mock and handed out
+// as opaque references. Global references outlive the mock, like the method
+// IDs and classes jni.hpp caches in statics.
+class MockJNIEnv {
+public:
+    struct Object {
+        enum class Kind { Class, ByteArray, ByteBuffer };
+
+        Kind kind = Kind::Class;
+        std::string name;
+        std::vector<char> bytes;
+        // Memory of direct buffers.
+        char* address = nullptr;
+        std::size_t capacity = 0u;
+        bool direct = false;
+        bool readOnly = false;
+        bool deleted = false;
+    };
+
+    MockJNIEnv() {
+        functions_.FindClass = &findClass;
+        functions_.GetMethodID = &getMethodID;
+        functions_.CallObjectMethodV = &callObjectMethodV;
+        functions_.CallObjectMethodA = &callObjectMethodA;
+        functions_.NewGlobalRef = &newGlobalRef;
+        functions_.DeleteLocalRef = &deleteLocalRef;
+        functions_.ThrowNew = &throwNew;
+        functions_.ExceptionCheck = &exceptionCheck;
+        functions_.NewByteArray = &newByteArray;
+        functions_.SetByteArrayRegion = &setByteArrayRegion;
+        functions_.GetArrayLength = &getArrayLength;
+        functions_.GetByteArrayRegion = &getByteArrayRegion;
+        functions_.NewDirectByteBuffer = &newDirectByteBuffer;
+        functions_.GetDirectBufferAddress = &getDirectBufferAddress;
+        functions_.GetDirectBufferCapacity = &getDirectBufferCapacity;
+        env_.functions = &functions_;
+        env_.mock = this;
+    }
+
+    MockJNIEnv(const MockJNIEnv&) = delete;
+    MockJNIEnv& operator=(const MockJNIEnv&) = delete;
+
+    JNIEnv& env() { return env_; }
+
+    // Creates a `byte[]` holding `bytes`, as Java code would pass it to a
+    // native method.
+    jni::Local<jni::Array<jni::jbyte>> newByteArray(const std::string& bytes) {
+        Object& object = addLocal(Object::Kind::ByteArray);
+        object.bytes.assign(bytes.begin(), bytes.end());
+        return jni::Local<jni::Array<jni::jbyte>>(env_, reinterpret_cast<jbyteArray>(&object));
+    }
+
+    // Creates a `ByteBuffer.allocate()` buffer.
+    jni::Local<jni::Object<mapbox::base::ByteBufferTag>> newHeapByteBuffer(std::size_t capacity) {
+        Object& object = addLocal(Object::Kind::ByteBuffer);
+        object.bytes.resize(capacity);
+        object.capacity = capacity;
+        return jni::Local<jni::Object<mapbox::base::ByteBufferTag>>(env_, reinterpret_cast<jobject>(&object));
+    }
+
+    static Object& object(jobject ref) { return *reinterpret_cast<Object*>(ref); }
+
+    // Number of JNI functions called.
+    std::size_t calls = 0u;
+    // Local references created by JNI functions and not deleted.
+    std::size_t localRefs = 0u;
+    // Arrays larger than this fail to allocate, with a pending exception.
+    std::size_t maxArraySize = 1u << 30;
+    bool exceptionPending = false;
+    // Class and message of the last exception raised with `ThrowNew()`.
+    std::string exceptionType;
+    std::string exceptionMessage;
+
+private:
+    using Functions = typename std::remove_const<typename std::remove_pointer<decltype(JNIEnv::functions)>::type>::type;
+
+    struct Env : JNIEnv {
+        MockJNIEnv* mock;
+    };
+
+    static MockJNIEnv& self(JNIEnv* env) {
+        MockJNIEnv& mock = *static_cast<Env*>(env)->mock;
+        mock.calls++;
+        return mock;
+    }
+
+    static jmethodID asReadOnlyBuffer() {
+        static char id;
+        return reinterpret_cast<jmethodID>(&id);
+    }
+
+    Object& add(Object::Kind kind) {
+        objects_.emplace_back();
+        objects_.back().kind = kind;
+        return objects_.back();
+    }
+
+    Object& addLocal(Object::Kind kind) {
+        localRefs++;
+        return add(kind);
+    }
+
+    static jclass JNICALL findClass(JNIEnv* env, const char* name) {
+        Object& object = self(env).addLocal(Object::Kind::Class);
+        object.name = name;
+        return reinterpret_cast<jclass>(&object);
+    }
+
+    static jmethodID JNICALL getMethodID(JNIEnv* env, jclass type, const char* name, const char* signature) {
+        self(env);
+        if (object(type).name == "java/nio/ByteBuffer" && std::strcmp(name, "asReadOnlyBuffer") == 0 &&
+            std::strcmp(signature, "()Ljava/nio/ByteBuffer;") == 0) {
+            return asReadOnlyBuffer();
+        }
+        return nullptr;
+    }
+
+    static jobject callObjectMethod(JNIEnv* env, jobject target, jmethodID method) {
+        MockJNIEnv& mock = self(env);
+        if (method != asReadOnlyBuffer()) return nullptr;
+        Object& object = mock.addLocal(Object::Kind::ByteBuffer);
+        object = MockJNIEnv::object(target);
+        object.readOnly = true;
+        return reinterpret_cast<jobject>(&object);
+    }
+
+    static jobject JNICALL callObjectMethodV(JNIEnv* env, jobject target, jmethodID method, va_list) {
+        return callObjectMethod(env, target, method);
+    }
+
+    static jobject JNICALL callObjectMethodA(JNIEnv* env, jobject target, jmethodID method, const jvalue*) {
+        return callObjectMethod(env, target, method);
+    }
+
+    static jobject JNICALL newGlobalRef(JNIEnv* env, jobject ref) {
+        self(env);
+        static std::deque<Object> globals;
+        globals.push_back(object(ref));
+        return reinterpret_cast<jobject>(&globals.back());
+    }
+
+    static void JNICALL deleteLocalRef(JNIEnv* env, jobject ref) {
+        MockJNIEnv& mock = self(env);
+        if (!ref) return;
+        object(ref).deleted = true;
+        mock.localRefs--;
+    }
+
+    static jint JNICALL throwNew(JNIEnv* env, jclass type, const char* message) {
+        MockJNIEnv& mock = self(env);
+        mock.exceptionPending = true;
+        mock.exceptionType = object(type).name;
+        mock.exceptionMessage = message ? message : "";
+        return JNI_OK;
+    }
+
+    static jboolean JNICALL exceptionCheck(JNIEnv* env) { return self(env).exceptionPending ? JNI_TRUE : JNI_FALSE; }
+
+    static jbyteArray JNICALL newByteArray(JNIEnv* env, jsize size) {
+        MockJNIEnv& mock = self(env);
+        if (static_cast<std::size_t>(size) > mock.maxArraySize) {
+            mock.exceptionPending = true;
+            return nullptr;
+        }
+        Object& object = mock.addLocal(Object::Kind::ByteArray);
+        object.bytes.resize(static_cast<std::size_t>(size));
+        return reinterpret_cast<jbyteArray>(&object);
+    }
+
+    static void JNICALL
+    setByteArrayRegion(JNIEnv* env, jbyteArray array, jsize start, jsize size, const jbyte* bytes) {
+        self(env);
+        Object& object = MockJNIEnv::object(array);
+        if (start < 0 || size < 0 || static_cast<std::size_t>(start) + size > object.bytes.size()) return;
+        std::memcpy(object.bytes.data() + start, bytes, static_cast<std::size_t>(size));
+    }
+
+    static jsize JNICALL getArrayLength(JNIEnv* env, jarray array) {
+        self(env);
+        return static_cast<jsize>(object(array).bytes.size());
+    }
+
+    static void JNICALL getByteArrayRegion(JNIEnv* env, jbyteArray array, jsize start, jsize size, jbyte* bytes) {
+        self(env);
+        const Object& object = MockJNIEnv::object(array);
+        if (start < 0 || size < 0 || static_cast<std::size_t>(start) + size > object.bytes.size()) return;
+        std::memcpy(bytes, object.bytes.data() + start, static_cast<std::size_t>(size));
+    }
+
+    static jobject JNICALL newDirectByteBuffer(JNIEnv* env, void* address, jlong capacity) {
+        Object& object = self(env).addLocal(Object::Kind::ByteBuffer);
+        object.address = static_cast<char*>(address);
+        object.capacity = static_cast<std::size_t>(capacity);
+        object.direct = true;
+        return reinterpret_cast<jobject>(&object);
+    }
+
+    static void* JNICALL getDirectBufferAddress(JNIEnv* env, jobject buffer) {
+        self(env);
+        return object(buffer).direct ? object(buffer).address : nullptr;
+    }
+
+    static jlong JNICALL getDirectBufferCapacity(JNIEnv* env, jobject buffer) {
+        self(env);
+        return object(buffer).direct ? static_cast<jlong>(object(buffer).capacity) : -1;
+    }
+
+    Functions functions_{};
+    Env env_{};
+    // Stable addresses for the references handed out.
+    std::deque<Object> objects_;
+};
@@ -0,0 +1,104 @@
+#include "mapbox/kdbush/static_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mapbox/io/io.hpp"
+#include "test_defines.hpp"
+
+using mapbox::base::StaticKDBush;
+
+namespace {
+
+struct Point {
+    double x;
+    double y;
+};
+
+std::vector<Point> randomPoints(std::size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(0.0, 1000.0);
+    std::vector<Point> points(count);
+    for (auto& point : points) {
+        point.x = distribution(generator);
+        point.y = distribution(generator);
+    }
+    return points;
+}
+
+} // namespace
+
+TEST(StaticKDBush, RangeAndWithin) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/kdbush.idx");
+    const std::vector<Point> points = randomPoints(10000);
+    ASSERT_TRUE(StaticKDBush::write(path, points, 16));
+
+    auto index = StaticKDBush::open(path);
+    ASSERT_TRUE(index);
+    EXPECT_EQ(index->size(), points.size());
+    EXPECT_EQ(index->nodeSize(), 16u);
+
+    std::vector<uint32_t> found;
+    index->range(200, 300, 450, 700, [&](uint32_t id) { found.push_back(id); });
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        if (points[i].x >= 200 && points[i].x <= 450 && points[i].y >= 300 && points[i].y <= 700) {
+            expected.push_back(i);
+        }
+    }
+    std::sort(found.begin(), found.end());
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(found, expected);
+
+    found.clear();
+    expected.clear();
+    index->within(500, 500, 120, [&](uint32_t id) { found.push_back(id); });
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        const double dx = points[i].x - 500;
+        const double dy = points[i].y - 500;
+        if (dx * dx + dy * dy <= 120 * 120) expected.push_back(i);
+    }
+    std::sort(found.begin(), found.end());
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(found, expected);
+
+    StaticKDBush moved = std::move(*index);
+    std::size_t count = 0;
+    moved.range(0, 0, 1000, 1000, [&](uint32_t) { ++count; });
+    EXPECT_EQ(count, points.size());
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
+
+TEST(StaticKDBush, Empty) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/kdbush_empty.idx");
+    ASSERT_TRUE(StaticKDBush::write(path, std::vector<Point>()));
+
+    auto index = StaticKDBush::open(path);
+    ASSERT_TRUE(index);
+    EXPECT_EQ(index->size(), 0u);
+    bool called = false;
+    index->within(0, 0, 1e9, [&](uint32_t) { called = true; });
+    EXPECT_FALSE(called);
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
+
+TEST(StaticKDBush, InvalidFile) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/kdbush_invalid.idx");
+    EXPECT_TRUE(mapbox::base::io::writeFile(path, "not an index"));
+
+    auto index = StaticKDBush::open(path);
+    EXPECT_FALSE(index);
+    EXPECT_EQ(index.error(), std::string("Invalid kdbush index file '") + path + "'");
+
+    auto missing = StaticKDBush::open("invalid");
+    EXPECT_FALSE(missing);
+    EXPECT_EQ(missing.error(), std::string("Failed to map file 'invalid'"));
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
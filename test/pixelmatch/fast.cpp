@@ -0,0 +1,198 @@
+#include "mapbox/pixelmatch/fast.hpp"
+
+#include <mapbox/pixelmatch.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using mapbox::base::PixelmatchKernel;
+using mapbox::base::PixelmatchOptions;
+
+namespace {
+
+const PixelmatchKernel kKernels[] = {PixelmatchKernel::Scalar, PixelmatchKernel::SSE41, PixelmatchKernel::AVX2};
+
+struct Images {
+    Images(std::size_t width_, std::size_t height_, unsigned seed) : width(width_), height(height_) {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<int> byte(0, 255);
+        std::uniform_int_distribution<int> change(0, 9);
+
+        img1.resize(width * height * 4);
+        for (auto& value : img1) {
+            value = static_cast<uint8_t>(byte(generator));
+        }
+        img2 = img1;
+        for (std::size_t i = 0; i < img2.size(); i += 4) {
+            if (change(generator) != 0) continue;
+            for (std::size_t c = 0; c < 4; ++c) {
+                img2[i + c] = static_cast<uint8_t>(byte(generator));
+            }
+        }
+    }
+
+    std::size_t width;
+    std::size_t height;
+    std::vector<uint8_t> img1;
+    std::vector<uint8_t> img2;
+};
+
+PixelmatchOptions withKernel(PixelmatchKernel kernel) {
+    PixelmatchOptions options;
+    options.kernel = kernel;
+    return options;
+}
+
+} // namespace
+
+TEST(Pixelmatch, Identical) {
+    const Images images(67, 13, 1);
+    for (const auto kernel : kKernels) {
+        if (!mapbox::base::pixelmatchKernelSupported(kernel)) continue;
+        EXPECT_EQ(mapbox::base::pixelmatch(
+                      images.img1.data(), images.img1.data(), images.width, images.height, nullptr, withKernel(kernel)),
+                  0u);
+    }
+}
+
+TEST(Pixelmatch, KernelsMatchScalar) {
+    const Images images(131, 47, 2);
+
+    for (const bool includeAA : {false, true}) {
+        PixelmatchOptions options = withKernel(PixelmatchKernel::Scalar);
+        options.includeAA = includeAA;
+        std::vector<uint8_t> expectedOutput(images.img1.size());
+        const uint64_t expected = mapbox::base::pixelmatch(
+            images.img1.data(), images.img2.data(), images.width, images.height, expectedOutput.data(), options);
+        EXPECT_GT(expected, 0u);
+
+        for (const auto kernel : kKernels) {
+            if (!mapbox::base::pixelmatchKernelSupported(kernel)) continue;
+            options.kernel = kernel;
+            std::vector<uint8_t> output(images.img1.size());
+            EXPECT_EQ(mapbox::base::pixelmatch(
+                          images.img1.data(), images.img2.data(), images.width, images.height, output.data(), options),
+                      expected);
+            EXPECT_EQ(output, expectedOutput);
+            EXPECT_EQ(mapbox::base::pixelmatch(
+                          images.img1.data(), images.img2.data(), images.width, images.height, nullptr, options),
+                      expected);
+        }
+    }
+}
+
+TEST(Pixelmatch, MatchesPixelmatchCpp) {
+    // Opaque black and white pixels, far away from the threshold.
+    const std::size_t width = 40;
+    const std::size_t height = 30;
+    std::vector<uint8_t> img1(width * height * 4, 255);
+    std::vector<uint8_t> img2 = img1;
+    for (std::size_t i = 0; i < img2.size(); i += 4 * 7) {
+        img2[i] = img2[i + 1] = img2[i + 2] = 0;
+    }
+
+    const uint64_t expected = mapbox::pixelmatch(img1.data(), img2.data(), width, height, nullptr, 0.1, true);
+    EXPECT_GT(expected, 0u);
+
+    PixelmatchOptions options;
+    options.includeAA = true;
+    EXPECT_EQ(mapbox::base::pixelmatch(img1.data(), img2.data(), width, height, nullptr, options), expected);
+}
+
+TEST(Pixelmatch, MatchesPixelmatchCppAntialiasing) {
+    // A vertical black and white edge, smoothed by a gray column in the
+    // second image, and a pixel that really changed.
+    const std::size_t width = 64;
+    const std::size_t height = 48;
+    std::vector<uint8_t> img1(width * height * 4, 255);
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width / 2; ++x) {
+            const std::size_t pos = (y * width + x) * 4;
+            img1[pos] = img1[pos + 1] = img1[pos + 2] = 0;
+        }
+    }
+    std::vector<uint8_t> img2 = img1;
+    for (std::size_t y = 0; y < height; ++y) {
+        const std::size_t pos = (y * width + width / 2) * 4;
+        img2[pos] = img2[pos + 1] = img2[pos + 2] = 128;
+    }
+    img2[(10 * width + 50) * 4] = 0;
+
+    const auto check = [](const Images& images) {
+        std::vector<uint8_t> expectedOutput(images.img1.size());
+        const uint64_t expected = mapbox::pixelmatch(images.img1.data(), images.img2.data(), images.width,
+                                                     images.height, expectedOutput.data(), 0.1, false);
+
+        for (const auto kernel : kKernels) {
+            if (!mapbox::base::pixelmatchKernelSupported(kernel)) continue;
+            std::vector<uint8_t> output(images.img1.size());
+            EXPECT_EQ(mapbox::base::pixelmatch(images.img1.data(), images.img2.data(), images.width, images.height,
+                                               output.data(), withKernel(kernel)),
+                      expected);
+            EXPECT_EQ(output, expectedOutput);
+        }
+        return expected;
+    };
+
+    Images edge(width, height, 0);
+    edge.img1 = img1;
+    edge.img2 = img2;
+    EXPECT_EQ(check(edge), 1u);
+    // The gray column is anti-aliasing, drawn in yellow.
+    std::vector<uint8_t> output(img1.size());
+    mapbox::base::pixelmatch(img1.data(), img2.data(), width, height, output.data(), PixelmatchOptions());
+    EXPECT_EQ(output[(5 * width + width / 2) * 4 + 2], 0u);
+
+    EXPECT_GT(check(Images(71, 29, 5)), 0u);
+}
+
+TEST(Pixelmatch, Threads) {
+    const Images images(257, 203, 3);
+    PixelmatchOptions options;
+    const uint64_t expected =
+        mapbox::base::pixelmatch(images.img1.data(), images.img2.data(), images.width, images.height, nullptr, options);
+
+    options.threads = 4;
+    std::vector<uint8_t> output(images.img1.size());
+    EXPECT_EQ(mapbox::base::pixelmatch(
+                  images.img1.data(), images.img2.data(), images.width, images.height, output.data(), options),
+              expected);
+
+    std::vector<uint8_t> expectedOutput(images.img1.size());
+    options.threads = 1;
+    mapbox::base::pixelmatch(
+        images.img1.data(), images.img2.data(), images.width, images.height, expectedOutput.data(), options);
+    EXPECT_EQ(output, expectedOutput);
+
+    mapbox::base::Scheduler scheduler(3);
+    options.scheduler = &scheduler;
+    options.threads = 0;
+    std::fill(output.begin(), output.end(), 0);
+    EXPECT_EQ(mapbox::base::pixelmatch(
+                  images.img1.data(), images.img2.data(), images.width, images.height, output.data(), options),
+              expected);
+    EXPECT_EQ(output, expectedOutput);
+}
+
+TEST(Pixelmatch, MaxMismatches) {
+    const Images images(512, 512, 4);
+    PixelmatchOptions options;
+    options.includeAA = true;
+    const uint64_t all =
+        mapbox::base::pixelmatch(images.img1.data(), images.img2.data(), images.width, images.height, nullptr, options);
+    ASSERT_GT(all, 1000u);
+
+    options.maxMismatches = 10;
+    const uint64_t partial =
+        mapbox::base::pixelmatch(images.img1.data(), images.img2.data(), images.width, images.height, nullptr, options);
+    EXPECT_GT(partial, 10u);
+    EXPECT_LT(partial, all);
+
+    options.maxMismatches = all;
+    EXPECT_EQ(
+        mapbox::base::pixelmatch(images.img1.data(), images.img2.data(), images.width, images.height, nullptr, options),
+        all);
+}
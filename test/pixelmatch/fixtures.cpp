@@ -0,0 +1,109 @@
+#if MB_TEST_PNG
+
+#include "mapbox/pixelmatch/fast.hpp"
+
+#include <mapbox/pixelmatch.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mapbox/io/directory.hpp"
+#include "mapbox/io/io.hpp"
+#include "png.hpp"
+#include "test_defines.hpp"
+
+using namespace mapbox::base;
+
+namespace {
+
+const std::string submodule = std::string(TEST_SOURCE_PATH) + "/deps/pixelmatch-cpp";
+
+const PixelmatchKernel kKernels[] = {PixelmatchKernel::Scalar, PixelmatchKernel::SSE41, PixelmatchKernel::AVX2};
+
+bool load(const std::string& path, PNGImage& image) {
+    const auto file = io::readFile(path);
+    return file && decodePNG(*file, image);
+}
+
+// The `<name>a.png` and `<name>b.png` image pairs of the submodule, without
+// the suffix.
+std::vector<std::string> fixturePairs() {
+    std::vector<std::string> pairs;
+    io::walkDirectory(submodule, [&](const io::DirectoryEntry& entry) {
+        const std::string& path = entry.path;
+        if (path.size() > 5 && path.compare(path.size() - 5, 5, "a.png") == 0) {
+            const std::string name = path.substr(0, path.size() - 5);
+            if (io::readFile(name + "b.png")) pairs.push_back(name);
+        }
+    });
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+} // namespace
+
+TEST(Pixelmatch, MatchesPixelmatchCppFixtures) {
+    const std::vector<std::string> pairs = fixturePairs();
+    ASSERT_FALSE(pairs.empty()) << "No fixtures found in " << submodule;
+
+    for (const std::string& name : pairs) {
+        SCOPED_TRACE(name);
+        PNGImage img1;
+        PNGImage img2;
+        ASSERT_TRUE(load(name + "a.png", img1));
+        ASSERT_TRUE(load(name + "b.png", img2));
+        if (img1.width != img2.width || img1.height != img2.height) continue;
+
+        for (const double threshold : {0.0, 0.05, 0.1}) {
+            for (const bool includeAA : {false, true}) {
+                std::vector<uint8_t> expectedOutput(img1.data.size());
+                const uint64_t expected = mapbox::pixelmatch(img1.data.data(),
+                                                             img2.data.data(),
+                                                             img1.width,
+                                                             img1.height,
+                                                             expectedOutput.data(),
+                                                             threshold,
+                                                             includeAA);
+
+                PixelmatchOptions options;
+                options.threshold = threshold;
+                options.includeAA = includeAA;
+                for (const auto kernel : kKernels) {
+                    if (!pixelmatchKernelSupported(kernel)) continue;
+                    options.kernel = kernel;
+                    for (const std::size_t threads : {1, 3}) {
+                        options.threads = threads;
+                        std::vector<uint8_t> output(img1.data.size());
+                        EXPECT_EQ(pixelmatch(img1.data.data(),
+                                             img2.data.data(),
+                                             img1.width,
+                                             img1.height,
+                                             output.data(),
+                                             options),
+                                  expected);
+                        EXPECT_TRUE(output == expectedOutput);
+                    }
+                }
+
+                // Stopping early still counts more than the limit, and a
+                // limit that is not exceeded does not change the result.
+                if (expected < 2u) continue;
+                options.kernel = PixelmatchKernel::Auto;
+                options.threads = 1;
+                options.maxMismatches = expected / 2;
+                const uint64_t partial =
+                    pixelmatch(img1.data.data(), img2.data.data(), img1.width, img1.height, nullptr, options);
+                EXPECT_GT(partial, expected / 2);
+                EXPECT_LE(partial, expected);
+                options.maxMismatches = expected;
+                EXPECT_EQ(pixelmatch(img1.data.data(), img2.data.data(), img1.width, img1.height, nullptr, options),
+                          expected);
+            }
+        }
+    }
+}
+
+#endif
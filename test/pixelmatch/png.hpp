@@ -0,0 +1,172 @@
+#pragma once
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Decodes the PNG test fixtures of pixelmatch-cpp to RGBA: 8-bit,
+// non-interlaced grayscale, RGB, palette and RGBA images. Transparency
+// chunks are only applied to palette images.
+struct PNGImage {
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::vector<uint8_t> data;
+};
+
+namespace png {
+
+inline uint32_t readUint32(const char* data) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data); // NOLINT
+    return (uint32_t{bytes[0]} << 24) | (uint32_t{bytes[1]} << 16) | (uint32_t{bytes[2]} << 8) | bytes[3];
+}
+
+inline uint8_t paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    return static_cast<uint8_t>(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+}
+
+} // namespace png
+
+inline bool decodePNG(const std::string& file, PNGImage& image) {
+    if (file.size() < 8 || file.compare(0, 8, "\x89PNG\r\n\x1a\n", 8) != 0) return false;
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint8_t depth = 0;
+    uint8_t colorType = 0;
+    uint8_t interlace = 0;
+    std::string compressed;
+    std::string palette;
+    std::string transparency;
+    for (std::size_t pos = 8; pos + 12 <= file.size();) {
+        const uint32_t length = png::readUint32(&file[pos]);
+        if (length > file.size() - pos - 12) return false;
+        const std::string type = file.substr(pos + 4, 4);
+        const char* chunk = &file[pos + 8];
+        if (type == "IHDR" && length >= 13) {
+            width = png::readUint32(chunk);
+            height = png::readUint32(chunk + 4);
+            depth = static_cast<uint8_t>(chunk[8]);
+            colorType = static_cast<uint8_t>(chunk[9]);
+            interlace = static_cast<uint8_t>(chunk[12]);
+        } else if (type == "PLTE") {
+            palette.assign(chunk, length);
+        } else if (type == "tRNS") {
+            transparency.assign(chunk, length);
+        } else if (type == "IDAT") {
+            compressed.append(chunk, length);
+        } else if (type == "IEND") {
+            break;
+        }
+        pos += 12 + length;
+    }
+    if (width == 0 || height == 0 || depth != 8 || interlace != 0) return false;
+
+    std::size_t channels = 0;
+    switch (colorType) {
+        case 0: // Grayscale.
+        case 3: // Palette.
+            channels = 1;
+            break;
+        case 2: // RGB.
+            channels = 3;
+            break;
+        case 4: // Grayscale and alpha.
+            channels = 2;
+            break;
+        case 6: // RGBA.
+            channels = 4;
+            break;
+        default:
+            return false;
+    }
+
+    // Every row starts with its filter type.
+    const std::size_t stride = width * channels;
+    std::vector<uint8_t> raw(height * (stride + 1));
+    uLongf rawSize = static_cast<uLongf>(raw.size());
+    if (uncompress(raw.data(),
+                   &rawSize,
+                   reinterpret_cast<const Bytef*>(compressed.data()), // NOLINT
+                   static_cast<uLong>(compressed.size())) != Z_OK ||
+        rawSize != raw.size()) {
+        return false;
+    }
+
+    std::vector<uint8_t> pixels(height * stride);
+    for (std::size_t y = 0; y < height; ++y) {
+        const uint8_t filter = raw[y * (stride + 1)];
+        const uint8_t* in = &raw[y * (stride + 1) + 1];
+        uint8_t* row = &pixels[y * stride];
+        const uint8_t* previous = y > 0 ? row - stride : nullptr;
+        for (std::size_t i = 0; i < stride; ++i) {
+            const int a = i >= channels ? row[i - channels] : 0;
+            const int b = previous ? previous[i] : 0;
+            const int c = previous && i >= channels ? previous[i - channels] : 0;
+            switch (filter) {
+                case 0:
+                    row[i] = in[i];
+                    break;
+                case 1:
+                    row[i] = static_cast<uint8_t>(in[i] + a);
+                    break;
+                case 2:
+                    row[i] = static_cast<uint8_t>(in[i] + b);
+                    break;
+                case 3:
+                    row[i] = static_cast<uint8_t>(in[i] + (a + b) / 2);
+                    break;
+                case 4:
+                    row[i] = static_cast<uint8_t>(in[i] + png::paeth(a, b, c));
+                    break;
+                default:
+                    return false;
+            }
+        }
+    }
+
+    image.width = width;
+    image.height = height;
+    image.data.resize(std::size_t{width} * height * 4);
+    for (std::size_t i = 0; i < std::size_t{width} * height; ++i) {
+        const uint8_t* in = &pixels[i * channels];
+        uint8_t* out = &image.data[i * 4];
+        switch (colorType) {
+            case 0:
+                out[0] = out[1] = out[2] = in[0];
+                out[3] = 255;
+                break;
+            case 2:
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
+                out[3] = 255;
+                break;
+            case 3:
+                if (std::size_t{in[0]} * 3 + 3 > palette.size()) return false;
+                out[0] = static_cast<uint8_t>(palette[in[0] * 3]);
+                out[1] = static_cast<uint8_t>(palette[in[0] * 3 + 1]);
+                out[2] = static_cast<uint8_t>(palette[in[0] * 3 + 2]);
+                out[3] = in[0] < transparency.size() ? static_cast<uint8_t>(transparency[in[0]]) : 255;
+                break;
+            case 4:
+                out[0] = out[1] = out[2] = in[0];
+                out[3] = in[1];
+                break;
+            default:
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
+                out[3] = in[3];
+                break;
+        }
+    }
+    return true;
+}
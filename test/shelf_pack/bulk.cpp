@@ -0,0 +1,101 @@
+#include "mapbox/shelf_pack/bulk.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using mapbox::Bin;
+using mapbox::ShelfPack;
+using namespace mapbox::base;
+
+TEST(ShelfPack, PackBulk) {
+    ShelfPack sprite(64, 64);
+    const std::vector<PackRequest> requests{{1, 10, 10}, {2, 10, 20}, {3, 64, 5}, {4, 10, 20}, {5, 10, 10}};
+
+    const std::vector<Bin*> bins = packBulk(sprite, requests);
+    ASSERT_EQ(bins.size(), requests.size());
+    for (std::size_t i = 0; i < bins.size(); ++i) {
+        ASSERT_NE(bins[i], nullptr);
+        EXPECT_EQ(bins[i]->id, requests[i].id);
+        EXPECT_EQ(bins[i]->w, requests[i].w);
+        EXPECT_EQ(bins[i]->h, requests[i].h);
+    }
+
+    // Tallest bins go first and open the top shelf; shorter ones fill it.
+    EXPECT_EQ(bins[1]->x, 0);
+    EXPECT_EQ(bins[3]->x, 10);
+    EXPECT_EQ(bins[0]->y, 0);
+    EXPECT_EQ(bins[4]->y, 0);
+    EXPECT_EQ(bins[2]->y, 20);
+
+    const PackStats stats = packStats(sprite, bins);
+    EXPECT_EQ(stats.binArea, 10 * 10 * 2 + 10 * 20 * 2 + 64 * 5);
+    EXPECT_EQ(stats.atlasArea, 64 * 64);
+    EXPECT_EQ(stats.usedHeight, 25);
+    EXPECT_DOUBLE_EQ(stats.occupancy, 920.0 / (64 * 64));
+    EXPECT_DOUBLE_EQ(stats.fragmentation, 1.0 - 920.0 / (64 * 25));
+
+    const std::vector<Bin*> overflow = packBulk(sprite, {{6, 65, 1}, {7, 8, 8}});
+    EXPECT_EQ(overflow[0], nullptr);
+    ASSERT_NE(overflow[1], nullptr);
+    EXPECT_EQ(overflow[1]->id, 7);
+}
+
+TEST(ShelfPack, Repack) {
+    ShelfPack sprite(32, 32);
+    Bin* a = sprite.packOne(1, 8, 4);
+    Bin* b = sprite.packOne(2, 8, 16);
+    Bin* c = sprite.packOne(3, 8, 4);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_NE(c, nullptr);
+    sprite.ref(*b);
+    EXPECT_EQ(b->y, 4);
+
+    const PackStats before = packStats(sprite, {a, b, c});
+
+    auto moves = repack(sprite, {1, 2, 3});
+    ASSERT_TRUE(moves);
+    ASSERT_EQ(moves->size(), 3u);
+    EXPECT_EQ((*moves)[1].id, 2);
+    EXPECT_EQ((*moves)[1].fromX, 0);
+    EXPECT_EQ((*moves)[1].fromY, 4);
+    EXPECT_EQ((*moves)[1].toX, 0);
+    EXPECT_EQ((*moves)[1].toY, 0);
+    EXPECT_EQ((*moves)[1].w, 8);
+    EXPECT_EQ((*moves)[1].h, 16);
+
+    // The old `Bin*` are invalidated; bins are looked up again by id.
+    Bin* repackedB = sprite.getBin(2);
+    ASSERT_NE(repackedB, nullptr);
+    EXPECT_EQ(repackedB->x, (*moves)[1].toX);
+    EXPECT_EQ(repackedB->y, (*moves)[1].toY);
+    EXPECT_EQ(repackedB->refcount(), 2);
+
+    const PackStats after = packStats(sprite, {sprite.getBin(1), repackedB, sprite.getBin(3)});
+    EXPECT_EQ(after.binArea, before.binArea);
+    EXPECT_LT(after.usedHeight, before.usedHeight);
+    EXPECT_LT(after.fragmentation, before.fragmentation);
+}
+
+TEST(ShelfPack, RepackInvalidIds) {
+    ShelfPack sprite(32, 32);
+    Bin* a = sprite.packOne(1, 8, 4);
+    Bin* b = sprite.packOne(2, 8, 16);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+
+    auto missing = repack(sprite, {1, 2, 42});
+    ASSERT_FALSE(missing);
+    EXPECT_EQ(missing.error(), "Bin 42 is not in the atlas");
+
+    auto repeated = repack(sprite, {2, 1, 2});
+    ASSERT_FALSE(repeated);
+    EXPECT_EQ(repeated.error(), "Bin 2 is listed twice");
+
+    // Rejected repacks leave the atlas and its bins untouched.
+    EXPECT_EQ(sprite.getBin(1), a);
+    EXPECT_EQ(sprite.getBin(2), b);
+    EXPECT_EQ(b->y, 4);
+    EXPECT_EQ(sprite.getBin(42), nullptr);
+}
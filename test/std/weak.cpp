@@ -6,6 +6,7 @@
 #include <chrono>
 #include <ctime>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -200,3 +201,79 @@ TEST(WeakPtr, WeakMethodBlock) {
     EXPECT_TRUE(g_call_finished);
     EXPECT_GE(totalTime, 100ms);
 }
+
+TEST(WeakPtr, ShardedSharedData) {
+    using SharedData = mapbox::base::internal::BasicWeakPtrSharedData<4, true>;
+    static_assert(sizeof(SharedData) >= 5 * MB_CACHE_LINE_SIZE, "Counters must not share cache lines");
+
+    auto data = std::make_shared<SharedData>();
+    std::atomic_bool stop{false};
+    std::atomic_int locked{0};
+    std::atomic_int lockedAfterInvalidation{0};
+    std::atomic_bool invalidated{false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 8; ++i) {
+        readers.emplace_back([&] {
+            const std::size_t shard = SharedData::currentShard();
+            EXPECT_LT(shard, 4u);
+            while (!stop) {
+                if (!data->sharedLock(shard)) continue;
+                if (data->valid()) {
+                    ++locked;
+                    if (invalidated) ++lockedAfterInvalidation;
+                    std::this_thread::yield();
+                    --locked;
+                }
+                data->sharedUnlock(shard);
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    data->invalidate();
+    invalidated = true;
+    // Invalidation waits for all the readers to release their lock.
+    EXPECT_EQ(locked, 0);
+    EXPECT_FALSE(data->valid());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    stop = true;
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(lockedAfterInvalidation, 0);
+}
+
+TEST(WeakPtr, GuardReleasedOnAnotherThread) {
+    struct Object {
+        mapbox::base::WeakPtrFactory<Object> factory_{this};
+    };
+
+    auto object = std::make_unique<Object>();
+    auto weak = object->factory_.makeWeakPtr();
+    auto guard = std::make_unique<mapbox::base::WeakPtrGuard>(weak.lock());
+    std::thread([&] { guard.reset(); }).join();
+
+    ASSERT_NO_THROW(object.reset()); // Should not block.
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(WeakPtr, WeakMethodBoundArguments) {
+    class Test {
+    public:
+        void append(std::unique_ptr<std::string>& prefix, const std::string& suffix) {
+            result += *prefix + suffix;
+        }
+
+        std::string result;
+        mapbox::base::WeakPtrFactory<Test> factory_{this};
+    };
+
+    auto t = std::make_unique<Test>();
+    auto weak = t->factory_.makeWeakMethod(&Test::append, std::make_unique<std::string>("a"));
+    weak("b");
+    weak(std::string("c"));
+    EXPECT_EQ(t->result, "abac");
+
+    t.reset();
+    weak("d"); // Ignored.
+}
@@ -0,0 +1,193 @@
+#include "mapbox/util/trace.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapbox/io/io.hpp"
+#include "mapbox/std/weak.hpp"
+#include "mapbox/util/chrome_trace.hpp"
+#include "mapbox/util/scheduler.hpp"
+#include "mapbox/util/type_wrapper.hpp"
+#include "test_defines.hpp"
+
+namespace trace = mapbox::base::trace;
+
+namespace {
+
+class TestSink final : public trace::Sink {
+public:
+    void duration(const char* name, trace::Clock::time_point start, trace::Clock::time_point end) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_LE(start, end);
+        durations[name]++;
+    }
+
+    void counter(const char* name, int64_t delta) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        counters[name] += delta;
+    }
+
+    void histogram(const char* name, double value) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        histograms[name].push_back(value);
+    }
+
+    std::mutex mutex;
+    std::map<std::string, int> durations;
+    std::map<std::string, int64_t> counters;
+    std::map<std::string, std::vector<double>> histograms;
+};
+
+} // namespace
+
+TEST(Trace, Macros) {
+    TestSink sink;
+    trace::setSink(&sink);
+    EXPECT_EQ(trace::getSink(), &sink);
+
+    {
+        MB_TRACE_SCOPE("scope");
+        MB_TRACE_COUNTER("counter", 2);
+        MB_TRACE_COUNTER("counter", -1);
+        MB_TRACE_HISTOGRAM("histogram", 4.5);
+    }
+
+    trace::setSink(nullptr);
+    MB_TRACE_COUNTER("counter", 10);
+
+    EXPECT_EQ(sink.durations["scope"], 1);
+    EXPECT_EQ(sink.counters["counter"], 1);
+    EXPECT_EQ(sink.histograms["histogram"], std::vector<double>{4.5});
+}
+
+TEST(Trace, IO) {
+    TestSink sink;
+    trace::setSink(&sink);
+
+    const std::string path(std::string(TEST_BINARY_PATH) + "/trace.txt");
+    EXPECT_TRUE(mapbox::base::io::writeFile(path, "12345"));
+    EXPECT_TRUE(mapbox::base::io::readFile(path));
+    EXPECT_FALSE(mapbox::base::io::readFile("invalid"));
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+
+    trace::setSink(nullptr);
+
+    EXPECT_EQ(sink.durations["io::writeFile"], 1);
+    EXPECT_EQ(sink.durations["io::readFile"], 2);
+    EXPECT_EQ(sink.durations["io::deleteFile"], 1);
+    EXPECT_EQ(sink.counters["io::readFile.errors"], 1);
+    EXPECT_EQ(sink.histograms["io::writeFile.bytes"], std::vector<double>{5});
+    EXPECT_EQ(sink.histograms["io::readFile.bytes"], std::vector<double>{5});
+}
+
+TEST(Trace, WeakPtr) {
+    struct Object {
+        mapbox::base::WeakPtrFactory<Object> factory{this};
+    };
+
+    TestSink sink;
+    trace::setSink(&sink);
+
+    auto object = std::make_unique<Object>();
+    auto weak = object->factory.makeWeakPtr();
+    {
+        auto guard = weak.lock();
+        EXPECT_TRUE(weak.get());
+    }
+    object.reset();
+    {
+        auto guard = weak.lock();
+        EXPECT_FALSE(weak.get());
+    }
+
+    trace::setSink(nullptr);
+
+    EXPECT_EQ(sink.durations["WeakPtrFactory::invalidate"], 1);
+    EXPECT_EQ(sink.counters["WeakPtr::lock.failed"], 1);
+}
+
+TEST(Trace, TypeWrapper) {
+    TestSink sink;
+    trace::setSink(&sink);
+
+    mapbox::base::TypeWrapper empty;
+    mapbox::base::TypeWrapper value(std::string("value"));
+    mapbox::base::TypeWrapper moved(std::move(value));
+    EXPECT_FALSE(empty.has_value());
+    EXPECT_TRUE(moved.has_value());
+
+    trace::setSink(nullptr);
+
+    // Moves do not allocate.
+    EXPECT_EQ(sink.counters["TypeWrapper.allocations"], 1);
+}
+
+TEST(Trace, Scheduler) {
+    TestSink sink;
+    trace::setSink(&sink);
+
+    {
+        mapbox::base::Scheduler scheduler(1);
+        std::atomic_bool started{false};
+        std::atomic_bool nestedDone{false};
+        std::atomic_int done{0};
+
+        // The worker blocks in the outer task until the calling thread stole
+        // the nested task from the worker queue and ran it.
+        scheduler.schedule([&] {
+            started = true;
+            scheduler.schedule([&] {
+                nestedDone = true;
+                done++;
+            });
+            while (!nestedDone) {
+                std::this_thread::yield();
+            }
+            done++;
+        });
+        while (!started) {
+            std::this_thread::yield();
+        }
+        while (done < 2) {
+            if (!scheduler.runPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    trace::setSink(nullptr);
+
+    EXPECT_EQ(sink.durations["Scheduler::task"], 2);
+    EXPECT_EQ(sink.counters["Scheduler.steals"], 1);
+}
+
+TEST(Trace, ChromeTraceWriter) {
+    const std::string path(std::string(TEST_BINARY_PATH) + "/trace.json");
+    trace::ChromeTraceWriter writer(path);
+    trace::setSink(&writer);
+
+    std::thread([] { MB_TRACE_SCOPE("worker \"scope\""); }).join();
+    MB_TRACE_COUNTER("counter", 3);
+    MB_TRACE_COUNTER("counter", 2);
+    MB_TRACE_HISTOGRAM("histogram", 0.25);
+
+    trace::setSink(nullptr);
+    EXPECT_EQ(writer.size(), 4u);
+    ASSERT_TRUE(writer.flush());
+
+    auto json = mapbox::base::io::readFile(path);
+    ASSERT_TRUE(json);
+    EXPECT_EQ(json->find("{\"traceEvents\":["), 0u);
+    EXPECT_NE(json->find("{\"name\":\"worker \\\"scope\\\"\",\"ph\":\"X\",\"pid\":1,\"tid\":0,"), std::string::npos);
+    EXPECT_NE(json->find("{\"name\":\"counter\",\"ph\":\"C\",\"pid\":1,\"tid\":1,"), std::string::npos);
+    EXPECT_NE(json->find("\"args\":{\"value\":5}}"), std::string::npos);
+    EXPECT_NE(json->find("\"args\":{\"value\":0.25}}"), std::string::npos);
+
+    EXPECT_TRUE(mapbox::base::io::deleteFile(path));
+}
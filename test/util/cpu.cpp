@@ -0,0 +1,63 @@
+#include "mapbox/util/cpu.hpp"
+
+#include <gtest/gtest.h>
+
+#include "mapbox/platform.hpp"
+
+using mapbox::base::CPUDispatch;
+using mapbox::base::CPUFeature;
+using mapbox::base::cpuFeatures;
+using mapbox::base::cpuSupports;
+
+namespace {
+
+int scalar() {
+    return 0;
+}
+int sse41() {
+    return 1;
+}
+int avx2() {
+    return 2;
+}
+
+} // namespace
+
+TEST(CPU, Features) {
+    EXPECT_TRUE(cpuSupports(CPUFeature::None));
+    EXPECT_EQ(cpuSupports(CPUFeature::AVX2 | CPUFeature::FMA),
+              cpuSupports(CPUFeature::AVX2) && cpuSupports(CPUFeature::FMA));
+
+    // Wider extensions imply the narrower ones on every shipping CPU.
+    if (cpuSupports(CPUFeature::AVX2)) {
+        EXPECT_TRUE(cpuSupports(CPUFeature::AVX));
+    }
+    if (cpuSupports(CPUFeature::AVX)) {
+        EXPECT_TRUE(cpuSupports(CPUFeature::SSE42));
+    }
+    if (cpuSupports(CPUFeature::SSE42)) {
+        EXPECT_TRUE(cpuSupports(CPUFeature::SSE41));
+    }
+
+#if MB_ARCH == MB_ARCH_X86_64
+    EXPECT_TRUE(cpuSupports(CPUFeature::SSE2));
+#elif MB_ARCH == MB_ARCH_ARM64
+    EXPECT_TRUE(cpuSupports(CPUFeature::NEON));
+#endif
+    EXPECT_EQ(cpuFeatures(), cpuFeatures());
+}
+
+TEST(CPU, Dispatch) {
+    using Fn = int (*)();
+    const CPUDispatch<Fn> dispatch =
+        CPUDispatch<Fn>(scalar).add(CPUFeature::SSE41, sse41).add(CPUFeature::AVX2 | CPUFeature::FMA, avx2);
+
+    EXPECT_EQ(dispatch.select(CPUFeature::None)(), 0);
+    EXPECT_EQ(dispatch.select(CPUFeature::NEON)(), 0);
+    EXPECT_EQ(dispatch.select(CPUFeature::SSE2 | CPUFeature::SSE41)(), 1);
+    EXPECT_EQ(dispatch.select(CPUFeature::SSE41 | CPUFeature::AVX2)(), 1);
+    EXPECT_EQ(dispatch.select(CPUFeature::SSE41 | CPUFeature::AVX2 | CPUFeature::FMA)(), 2);
+
+    const int expected = cpuSupports(CPUFeature::AVX2 | CPUFeature::FMA) ? 2 : cpuSupports(CPUFeature::SSE41) ? 1 : 0;
+    EXPECT_EQ(dispatch.select()(), expected);
+}
@@ -0,0 +1,215 @@
+#include "mapbox/util/memory.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace mapbox::base;
+
+namespace {
+
+class CountingResource final : public MemoryResource {
+public:
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes = 0;
+
+protected:
+    void* doAllocate(std::size_t size, std::size_t alignment) override {
+        allocations++;
+        bytes += size;
+        return newDeleteResource()->allocate(size, alignment);
+    }
+
+    void doDeallocate(void* ptr, std::size_t size, std::size_t alignment) override {
+        deallocations++;
+        bytes -= size;
+        newDeleteResource()->deallocate(ptr, size, alignment);
+    }
+};
+
+bool isAligned(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0; // NOLINT
+}
+
+} // namespace
+
+TEST(Memory, NewDeleteResource) {
+    MemoryResource* resource = newDeleteResource();
+    EXPECT_EQ(resource, newDeleteResource());
+    EXPECT_TRUE(resource->isEqual(*newDeleteResource()));
+
+    for (std::size_t alignment : {1u, 8u, 64u, 256u}) {
+        void* ptr = resource->allocate(100, alignment);
+        EXPECT_TRUE(isAligned(ptr, alignment));
+        resource->deallocate(ptr, 100, alignment);
+    }
+}
+
+TEST(Memory, MonotonicBuffer) {
+    CountingResource upstream;
+    {
+        MonotonicBufferResource arena(128, &upstream);
+        EXPECT_FALSE(arena.isEqual(upstream));
+
+        void* a = arena.allocate(10, 1);
+        void* b = arena.allocate(8, 8);
+        void* c = arena.allocate(4, 32);
+        EXPECT_TRUE(isAligned(b, 8));
+        EXPECT_TRUE(isAligned(c, 32));
+        EXPECT_LT(a, b);
+        EXPECT_LT(b, c);
+        EXPECT_EQ(upstream.allocations, 1u);
+
+        // Deallocation is a no-op, chunks grow and oversized requests fit.
+        arena.deallocate(c, 4, 32);
+        void* large = arena.allocate(4096, 16);
+        EXPECT_TRUE(isAligned(large, 16));
+        EXPECT_EQ(upstream.allocations, 2u);
+
+        arena.release();
+        EXPECT_EQ(upstream.deallocations, 2u);
+        EXPECT_EQ(upstream.bytes, 0u);
+
+        arena.allocate(1000);
+        EXPECT_EQ(upstream.allocations, 3u);
+    }
+    EXPECT_EQ(upstream.deallocations, 3u);
+    EXPECT_EQ(upstream.bytes, 0u);
+}
+
+TEST(Memory, MonotonicInitialBuffer) {
+    CountingResource upstream;
+    alignas(16) char buffer[256];
+    MonotonicBufferResource arena(buffer, sizeof(buffer), &upstream);
+
+    std::vector<int, PolymorphicAllocator<int>> values(&arena);
+    values.reserve(32);
+    for (int i = 0; i < 32; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_GE(static_cast<const void*>(values.data()), static_cast<const void*>(buffer));
+    EXPECT_LT(static_cast<const void*>(values.data()), static_cast<const void*>(buffer + sizeof(buffer)));
+    EXPECT_EQ(upstream.allocations, 0u);
+
+    values.reserve(1024);
+    EXPECT_EQ(upstream.allocations, 1u);
+
+    arena.release();
+    EXPECT_EQ(arena.allocate(16), buffer);
+}
+
+TEST(Memory, PoolReusesBlocks) {
+    CountingResource upstream;
+    {
+        PoolResource pool(24, 64, &upstream);
+        EXPECT_EQ(pool.blockSize() % alignof(std::max_align_t), 0u);
+        EXPECT_GE(pool.blockSize(), 24u);
+
+        std::set<void*> blocks;
+        for (int i = 0; i < 100; ++i) {
+            void* ptr = pool.allocate(24);
+            EXPECT_TRUE(isAligned(ptr, alignof(std::max_align_t)));
+            EXPECT_TRUE(blocks.insert(ptr).second);
+        }
+        EXPECT_EQ(upstream.allocations, 2u);
+
+        for (void* ptr : blocks) {
+            pool.deallocate(ptr, 24);
+        }
+        std::set<void*> reused;
+        for (int i = 0; i < 128; ++i) {
+            EXPECT_TRUE(reused.insert(pool.allocate(16)).second);
+        }
+        EXPECT_EQ(upstream.allocations, 2u);
+        for (void* ptr : blocks) {
+            EXPECT_EQ(reused.count(ptr), 1u);
+        }
+
+        // Large requests bypass the pool.
+        void* large = pool.allocate(1000);
+        EXPECT_EQ(upstream.allocations, 3u);
+        pool.deallocate(large, 1000);
+        EXPECT_EQ(upstream.deallocations, 1u);
+    }
+    EXPECT_EQ(upstream.deallocations, 3u);
+    EXPECT_EQ(upstream.bytes, 0u);
+}
+
+TEST(Memory, PoolThreads) {
+    CountingResource upstream;
+    PoolResource pool(32, 128, &upstream);
+    constexpr int kThreads = 8;
+    constexpr int kBlocks = 1000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&pool, t] {
+            std::vector<int*> blocks;
+            for (int round = 0; round < 10; ++round) {
+                for (int i = 0; i < kBlocks; ++i) {
+                    auto* block = static_cast<int*>(pool.allocate(sizeof(int) * 8));
+                    block[0] = t;
+                    block[7] = i;
+                    blocks.push_back(block);
+                }
+                for (int i = 0; i < kBlocks; ++i) {
+                    EXPECT_EQ(blocks[i][0], t);
+                    EXPECT_EQ(blocks[i][7], i);
+                    pool.deallocate(blocks[i], sizeof(int) * 8);
+                }
+                blocks.clear();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Blocks freed by a thread are reused instead of growing the pool.
+    EXPECT_LE(upstream.allocations, static_cast<std::size_t>(kThreads * (kBlocks / 128 + 2)));
+}
+
+TEST(Memory, PoolOnHeap) {
+    // Not over-aligned, so that `new` honors its alignment in C++14.
+    static_assert(alignof(PoolResource) <= alignof(std::max_align_t), "PoolResource must not be over-aligned");
+
+    CountingResource upstream;
+    {
+        auto pool = std::make_unique<PoolResource>(32, 16, &upstream);
+        EXPECT_TRUE(isAligned(pool.get(), alignof(PoolResource)));
+        std::vector<void*> blocks;
+        for (int i = 0; i < 100; ++i) {
+            blocks.push_back(pool->allocate(32));
+            EXPECT_TRUE(isAligned(blocks.back(), alignof(std::max_align_t)));
+        }
+        for (void* ptr : blocks) {
+            pool->deallocate(ptr, 32);
+        }
+    }
+    EXPECT_EQ(upstream.bytes, 0u);
+}
+
+TEST(Memory, PolymorphicAllocator) {
+    MonotonicBufferResource arena;
+    PoolResource pool(64);
+
+    PolymorphicAllocator<int> a(&arena);
+    PolymorphicAllocator<double> b(a);
+    PolymorphicAllocator<int> c(&pool);
+    EXPECT_EQ(a.resource(), &arena);
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a != c);
+    EXPECT_EQ(PolymorphicAllocator<int>().resource(), newDeleteResource());
+
+    using String = std::basic_string<char, std::char_traits<char>, PolymorphicAllocator<char>>;
+    std::vector<String, PolymorphicAllocator<String>> strings(&arena);
+    for (int i = 0; i < 100; ++i) {
+        strings.emplace_back(String("a string too long for the small string buffer", &arena));
+    }
+    EXPECT_EQ(strings.back().get_allocator().resource(), &arena);
+}
@@ -0,0 +1,160 @@
+#include "mapbox/util/scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "mapbox/std/weak.hpp"
+
+using mapbox::base::parallelFor;
+using mapbox::base::parallelSort;
+using mapbox::base::Scheduler;
+using mapbox::base::TaskPriority;
+
+TEST(Scheduler, Schedule) {
+    std::atomic_int count{0};
+    {
+        Scheduler scheduler(4);
+        EXPECT_EQ(scheduler.threadCount(), 4u);
+        for (int i = 0; i < 1000; ++i) {
+            scheduler.schedule([&] {
+                ++count;
+            });
+        }
+    }
+    // Pending tasks run before the scheduler is destroyed.
+    EXPECT_EQ(count, 1000);
+}
+
+TEST(Scheduler, NestedTasks) {
+    Scheduler scheduler(3);
+    std::atomic_int count{0};
+    for (int i = 0; i < 10; ++i) {
+        scheduler.schedule([&] {
+            for (int j = 0; j < 10; ++j) {
+                scheduler.schedule([&] { ++count; });
+            }
+        });
+    }
+    while (count < 100) {
+        if (!scheduler.runPendingTask()) std::this_thread::yield();
+    }
+    EXPECT_EQ(count, 100);
+}
+
+TEST(Scheduler, Priorities) {
+    Scheduler scheduler(1);
+    std::atomic_bool started{false};
+    std::atomic_bool release{false};
+    scheduler.schedule([&] {
+        started = true;
+        while (!release) std::this_thread::yield();
+    });
+    while (!started) std::this_thread::yield();
+
+    std::mutex mutex;
+    std::vector<int> order;
+    const auto record = [&](int value) {
+        return [&, value] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(value);
+        };
+    };
+    scheduler.schedule(record(3), TaskPriority::Low);
+    scheduler.schedule(record(2), TaskPriority::Normal);
+    scheduler.schedule(record(1), TaskPriority::High);
+    scheduler.schedule(record(4), TaskPriority::Low);
+    release = true;
+
+    while (true) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (order.size() == 4u) break;
+    }
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST(Scheduler, WeakPtrOwner) {
+    struct Owner {
+        void inc() { ++count; }
+        std::atomic_int count{0};
+        mapbox::base::WeakPtrFactory<Owner> factory{this};
+    };
+
+    Scheduler scheduler(1);
+    std::atomic_bool release{false};
+    scheduler.schedule([&] {
+        while (!release) std::this_thread::yield();
+    });
+
+    auto alive = std::make_unique<Owner>();
+    auto dead = std::make_unique<Owner>();
+    std::atomic_int ran{0};
+    scheduler.schedule(alive->factory.makeWeakPtr(), [&](Owner& owner) {
+        owner.inc();
+        ++ran;
+    });
+    scheduler.schedule(dead->factory.makeWeakPtr(), [&](Owner& owner) {
+        owner.inc();
+        ++ran;
+    });
+    dead.reset();
+    scheduler.schedule([&] { ++ran; }, TaskPriority::Low);
+    release = true;
+
+    while (ran < 2) std::this_thread::yield();
+    EXPECT_EQ(alive->count, 1);
+    EXPECT_EQ(ran, 2);
+}
+
+TEST(Scheduler, ParallelFor) {
+    Scheduler scheduler(4);
+    std::vector<int> values(10000, 0);
+    parallelFor(scheduler, 0, values.size(), [&](std::size_t i) { values[i] += static_cast<int>(i); }, 64);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(values[i], static_cast<int>(i));
+    }
+
+    // Nested loops run on the same workers without deadlocking.
+    std::atomic_int count{0};
+    parallelFor(scheduler, 0, 16, [&](std::size_t) {
+        parallelFor(scheduler, 0, 100, [&](std::size_t) { ++count; });
+    });
+    EXPECT_EQ(count, 1600);
+
+    parallelFor(scheduler, 5, 5, [&](std::size_t) { FAIL(); });
+
+    EXPECT_THROW(parallelFor(scheduler,
+                             0,
+                             1000,
+                             [&](std::size_t i) {
+                                 if (i == 500) throw std::runtime_error("error");
+                             }),
+                 std::runtime_error);
+}
+
+TEST(Scheduler, ParallelSort) {
+    Scheduler scheduler(4);
+    std::mt19937 generator(7);
+    std::vector<uint32_t> values(100000);
+    for (auto& value : values) value = generator();
+    std::vector<uint32_t> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    parallelSort(scheduler, values.begin(), values.end());
+    EXPECT_EQ(values, expected);
+
+    parallelSort(scheduler, values.begin(), values.end(), [](uint32_t a, uint32_t b) { return a > b; });
+    std::reverse(expected.begin(), expected.end());
+    EXPECT_EQ(values, expected);
+
+    std::vector<int> small{3, 1, 2};
+    parallelSort(scheduler, small.begin(), small.end());
+    EXPECT_EQ(small, (std::vector<int>{1, 2, 3}));
+}
@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 using mapbox::base::TypeWrapper;
 
 namespace {
@@ -172,3 +176,40 @@ TEST(TypeWrapper, SharedPtr) {
     shared = nullptr;
     EXPECT_EQ(weak.use_count(), 0);
 }
+
+TEST(TypeWrapper, MemoryResource) {
+    mapbox::base::MonotonicBufferResource arena;
+    int32_t p = 0;
+
+    struct T {
+        explicit T(int32_t* p_) : p(p_) { (*p)++; }
+        T(T&& t) noexcept : p(t.p) { (*p)++; }
+        ~T() { (*p)--; }
+        T(const T&) = delete;
+        T& operator=(const T&) = delete;
+
+        int32_t* p;
+        alignas(32) char data[32] = {};
+    };
+
+    {
+        TypeWrapper u1(std::allocator_arg, &arena, T(&p));
+        EXPECT_EQ(p, 1);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&u1.get<T>()) % 32, 0u); // NOLINT
+
+        TypeWrapper u2(std::allocator_arg, &arena, std::string("value"));
+        EXPECT_EQ(u2.get<std::string>(), "value");
+
+        u2 = std::move(u1);
+        EXPECT_EQ(p, 1);
+    }
+    EXPECT_EQ(p, 0);
+
+    mapbox::base::PoolResource pool(64, 16);
+    std::vector<TypeWrapper> values;
+    for (int i = 0; i < 100; ++i) {
+        values.emplace_back(std::allocator_arg, &pool, i);
+    }
+    EXPECT_EQ(values[42].get<int>(), 42);
+    EXPECT_EQ(sizeof(TypeWrapper), sizeof(void*) * 2);
+}
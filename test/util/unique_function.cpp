@@ -0,0 +1,117 @@
+#include "mapbox/util/unique_function.hpp"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "mapbox/std/weak.hpp"
+
+using mapbox::base::UniqueFunction;
+
+namespace {
+
+int add(int a, int b) {
+    return a + b;
+}
+
+struct Counted {
+    explicit Counted(int& instances_) : instances(&instances_) { ++*instances; }
+    Counted(Counted&& other) noexcept : instances(other.instances) { ++*instances; }
+    Counted(const Counted&) = delete;
+    ~Counted() { --*instances; }
+    int operator()() const { return 42; }
+    int* instances;
+};
+
+class Object {
+public:
+    void set(int value) { value_ = value; }
+    int value_ = 0;
+    mapbox::base::WeakPtrFactory<Object> factory_{this};
+};
+
+} // namespace
+
+TEST(UniqueFunction, Empty) {
+    UniqueFunction<void()> empty;
+    EXPECT_FALSE(empty);
+    UniqueFunction<void()> null(nullptr);
+    EXPECT_FALSE(null);
+    void (*pointer)() = nullptr;
+    UniqueFunction<void()> nullPointer(pointer);
+    EXPECT_FALSE(nullPointer);
+}
+
+TEST(UniqueFunction, Call) {
+    UniqueFunction<int(int, int)> function(add);
+    ASSERT_TRUE(function);
+    EXPECT_EQ(function(1, 2), 3);
+
+    int offset = 10;
+    function = [offset](int a, int b) { return a + b + offset; };
+    EXPECT_EQ(function(1, 2), 13);
+
+    auto owned = std::make_unique<std::string>("moved");
+    UniqueFunction<std::string(const std::string&)> moveOnly = [owned = std::move(owned)](const std::string& suffix) {
+        return *owned + suffix;
+    };
+    EXPECT_EQ(moveOnly(" only"), "moved only");
+
+    UniqueFunction<void(std::unique_ptr<int>)> sink = [](std::unique_ptr<int> value) { EXPECT_EQ(*value, 7); };
+    sink(std::make_unique<int>(7));
+}
+
+TEST(UniqueFunction, MoveAndDestroy) {
+    int instances = 0;
+    {
+        UniqueFunction<int()> function{Counted(instances)};
+        EXPECT_EQ(instances, 1);
+        EXPECT_EQ(function(), 42);
+
+        UniqueFunction<int()> moved = std::move(function);
+        EXPECT_FALSE(function); // NOLINT bugprone-use-after-move
+        EXPECT_EQ(instances, 1);
+        EXPECT_EQ(moved(), 42);
+
+        moved = nullptr;
+        EXPECT_EQ(instances, 0);
+        moved = Counted(instances);
+        EXPECT_EQ(instances, 1);
+    }
+    EXPECT_EQ(instances, 0);
+}
+
+TEST(UniqueFunction, Heap) {
+    struct Large {
+        char data[256] = {'a'};
+        char operator()() const { return data[0]; }
+    };
+    static_assert(!UniqueFunction<char()>::storesInline<Large>(), "");
+    static_assert(UniqueFunction<char(), sizeof(Large)>::storesInline<Large>(), "");
+
+    UniqueFunction<char()> function{Large()};
+    UniqueFunction<char()> moved = std::move(function);
+    EXPECT_EQ(moved(), 'a');
+}
+
+TEST(UniqueFunction, WeakMethod) {
+    auto object = std::make_unique<Object>();
+    auto weakMethod = object->factory_.makeWeakMethod(&Object::set);
+    static_assert(UniqueFunction<void(int)>::storesInline<decltype(weakMethod)>(),
+                  "Weak methods must not allocate");
+
+    UniqueFunction<void(int)> function = std::move(weakMethod);
+    function(3);
+    EXPECT_EQ(object->value_, 3);
+
+    UniqueFunction<void()> bound = object->factory_.makeWeakMethod(&Object::set, 5);
+    bound();
+    EXPECT_EQ(object->value_, 5);
+
+    object.reset();
+    function(4); // Ignored.
+    bound();
+}